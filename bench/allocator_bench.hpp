@@ -0,0 +1,66 @@
+#pragma once
+
+#include <kty/containers/allocator.hpp>
+#include <kty/containers/stringpool.hpp>
+
+#include <bench/benchmark.hpp>
+
+using namespace kty;
+
+/*!
+    @brief  Times allocate/deallocate pairs on an allocator that has been
+            pre-filled to different levels, from empty to 95% full.
+*/
+void bench_allocator_fill_levels() {
+    print_bench_heading("allocator_fill_levels");
+    const int numBlocks = 1000;
+    const int numOps = 200000;
+    static Allocator<numBlocks, Sizes::alloc_block_size> allocator;
+    static void * taken[numBlocks];
+    int const fillPercents[] = {0, 25, 50, 75, 95};
+    char label[32];
+    for (int fillPercent : fillPercents) {
+        int numTaken = numBlocks * fillPercent / 100;
+        for (int i = 0; i < numTaken; ++i) {
+            taken[i] = allocator.allocate();
+        }
+        Stopwatch stopwatch;
+        for (int i = 0; i < numOps; ++i) {
+            allocator.deallocate(allocator.allocate());
+        }
+        snprintf(label, sizeof(label), "%d%% full", fillPercent);
+        print_bench_result(label, stopwatch.elapsed_ns() / numOps, "ns per allocate + deallocate");
+        for (int i = 0; i < numTaken; ++i) {
+            allocator.deallocate(taken[i]);
+        }
+    }
+}
+
+/*!
+    @brief  Times allocate_idx/deallocate_idx pairs on a string pool that has
+            been pre-filled to different levels, from empty to 95% full.
+*/
+void bench_stringpool_fill_levels() {
+    print_bench_heading("stringpool_fill_levels");
+    const int numStrings = 1000;
+    const int numOps = 200000;
+    static StringPool<numStrings, Sizes::string_length> pool;
+    static int taken[numStrings];
+    int const fillPercents[] = {0, 25, 50, 75, 95};
+    char label[32];
+    for (int fillPercent : fillPercents) {
+        int numTaken = numStrings * fillPercent / 100;
+        for (int i = 0; i < numTaken; ++i) {
+            taken[i] = pool.allocate_idx();
+        }
+        Stopwatch stopwatch;
+        for (int i = 0; i < numOps; ++i) {
+            pool.deallocate_idx(pool.allocate_idx());
+        }
+        snprintf(label, sizeof(label), "%d%% full", fillPercent);
+        print_bench_result(label, stopwatch.elapsed_ns() / numOps, "ns per allocate_idx + deallocate_idx");
+        for (int i = 0; i < numTaken; ++i) {
+            pool.deallocate_idx(taken[i]);
+        }
+    }
+}
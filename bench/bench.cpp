@@ -0,0 +1,57 @@
+/*!
+    Desktop benchmarks for the containers and the interpreter.
+    Build and run with `make bench`.
+*/
+#if !defined(ARDUINO)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include "ArduinoUnit.h"
+#include "ArduinoUnitMock.h"
+CppIOStream Serial;
+
+#include <kitty.hpp>
+#include <test/mock_arduino.hpp>
+#include <test/mock_arduino_log.hpp>
+MockArduinoLog Log;
+
+#include <kty/containers/allocator.hpp>
+#include <kty/containers/stringpool.hpp>
+
+using namespace kty;
+
+SlabAllocator<>     alloc;
+StringPool<>        stringPool;
+GetAllocInit<>      getAllocInit(alloc);
+GetStringPoolInit<> getStringPoolInit(stringPool);
+
+#include <bench/allocator_bench.hpp>
+#include <bench/deque_bench.hpp>
+#include <bench/group_store_bench.hpp>
+#include <bench/interpreter_bench.hpp>
+#include <bench/policy_bench.hpp>
+#include <bench/symbol_table_bench.hpp>
+
+int main(void) {
+    Log.to_log_verbose(false);
+    Log.to_log_trace(false);
+    Log.to_log_notice(false);
+    Log.to_log_warning(false);
+    Log.to_log_error(false);
+
+    bench_allocator_fill_levels();
+    bench_stringpool_fill_levels();
+    bench_deque_node_footprint();
+    bench_ring_deque_access();
+    bench_static_policies();
+    bench_symbol_table_scaling();
+    bench_group_store();
+    bench_run_group_repeats();
+    bench_interpreter_examples();
+
+    return 0;
+}
+
+#endif
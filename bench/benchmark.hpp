@@ -0,0 +1,74 @@
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include <chrono>
+
+/*!
+    @brief  Simple stopwatch used to time benchmark loops on desktop.
+*/
+class Stopwatch {
+
+public:
+    /*!
+        @brief  Constructor for the stopwatch, which starts timing immediately.
+    */
+    Stopwatch() {
+        restart();
+    }
+
+    /*!
+        @brief  Restarts timing from now.
+    */
+    void restart() {
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    /*!
+        @brief  Gets the time elapsed since the last restart.
+
+        @return The elapsed time in nanoseconds.
+    */
+    double elapsed_ns() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+
+};
+
+/*!
+    @brief  Prints the heading for a group of benchmark results.
+
+    @param  name
+            The name of the benchmark.
+*/
+void print_bench_heading(char const * name) {
+    Serial.println("");
+    Serial.print("Benchmark ");
+    Serial.println(name);
+}
+
+/*!
+    @brief  Prints a single benchmark result.
+
+    @param  label
+            What was measured.
+
+    @param  value
+            The measured value.
+
+    @param  unit
+            The unit of the measured value.
+*/
+void print_bench_result(char const * label, double value, char const * unit) {
+    Serial.print("    ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print(value);
+    Serial.print(" ");
+    Serial.println(unit);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <kty/containers/allocator.hpp>
+#include <kty/containers/deque.hpp>
+#include <kty/containers/ring_deque.hpp>
+#include <kty/containers/string.hpp>
+#include <kty/token.hpp>
+
+#include <bench/benchmark.hpp>
+
+using namespace kty;
+
+/*!
+    @brief  Prints the node size of a deque, and the block size it takes up
+            in the slab allocator.
+
+    @param  name
+            The deque type being reported.
+*/
+template <typename Deque>
+void print_deque_node_footprint(char const * name) {
+    Serial.print("    ");
+    Serial.print(name);
+    Serial.print(": node is ");
+    Serial.print((int)sizeof(typename Deque::Node));
+    Serial.print(" bytes, uses a ");
+    Serial.print(decltype(alloc)::block_size_for(sizeof(typename Deque::Node)));
+    Serial.print(" byte block (single block size is ");
+    Serial.print(Sizes::alloc_block_size);
+    Serial.println(" bytes)");
+}
+
+/*!
+    @brief  Reports how many bytes each deque element takes up in the allocator.
+*/
+void bench_deque_node_footprint() {
+    print_bench_heading("deque_node_footprint");
+    print_deque_node_footprint<Deque<int>>("Deque<int>");
+    print_deque_node_footprint<Deque<PoolString<>>>("Deque<PoolString<>>");
+    print_deque_node_footprint<Deque<Token<>>>("Deque<Token<>>");
+}
+
+/*!
+    @brief  Times indexed reads and push and pop at both ends of a deque.
+
+    @param  deque
+            The deque to time, which must start out empty.
+
+    @param  name
+            The deque type being reported.
+*/
+template <typename Deque>
+void time_deque_access(Deque & deque, char const * name) {
+    const int numValues = 32;
+    const int numRuns = 2000;
+    char label[64];
+    volatile int sink = 0;
+
+    Stopwatch stopwatch;
+    for (int run = 0; run < numRuns; ++run) {
+        for (int i = 0; i < numValues; ++i) {
+            deque.push_back(i);
+        }
+        int sum = 0;
+        for (int i = 0; i < numValues; ++i) {
+            sum += deque[i];
+        }
+        sink = sink + sum;
+        deque.clear();
+    }
+    snprintf(label, sizeof(label), "%s index %d values", name, numValues);
+    print_bench_result(label, stopwatch.elapsed_ns() / numRuns, "ns");
+
+    stopwatch.restart();
+    for (int run = 0; run < numRuns; ++run) {
+        for (int i = 0; i < numValues / 2; ++i) {
+            deque.push_front(i);
+            deque.push_back(i);
+        }
+        while (!deque.is_empty()) {
+            sink = sink + deque.front() + deque.back();
+            deque.pop_front();
+            deque.pop_back();
+        }
+    }
+    snprintf(label, sizeof(label), "%s push and pop %d values", name, numValues);
+    print_bench_result(label, stopwatch.elapsed_ns() / numRuns, "ns");
+}
+
+/*!
+    @brief  Compares the linked deque to the ring buffer deque,
+            for indexed access and for use at both ends.
+*/
+void bench_ring_deque_access() {
+    print_bench_heading("ring_deque_access");
+    Deque<int> deque;
+    RingDeque<int, 32> ringDeque;
+    time_deque_access(deque, "Deque<int>");
+    time_deque_access(ringDeque, "RingDeque<int, 32>");
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <iostream>
+
+#include <kty/containers/deque_of_deque.hpp>
+#include <kty/containers/string.hpp>
+#include <kty/interpreter.hpp>
+
+#include <bench/benchmark.hpp>
+
+using namespace kty;
+
+/*!
+    @brief  Times filling and reading groups of 100 or more commands,
+            in the group store and through the interpreter.
+            Each group cycles through a few different commands, which are
+            interned, so the groups do not run out of strings.
+*/
+void bench_group_store() {
+    print_bench_heading("group_store");
+    const int numRuns = 20;
+    const int numCommandStrings = 10;
+    static DequeDequePoolString<> groups;
+    static Interpreter<> interpreter;
+    PoolString<> commands[numCommandStrings];
+    int const numsCommands[] = {100, 200, 400};
+    char label[64];
+    char command[32];
+    volatile int sink = 0;
+
+    for (int i = 0; i < numCommandStrings; ++i) {
+        snprintf(command, sizeof(command), "total IsNumber(total + %d)", i);
+        commands[i] = command;
+    }
+
+    for (int numCommands : numsCommands) {
+        Stopwatch stopwatch;
+        for (int run = 0; run < numRuns; ++run) {
+            groups.clear();
+            // The groups are filled in turns, so each command moves the ones after it
+            for (int g = 0; g < 4; ++g) {
+                groups.push_back();
+            }
+            for (int j = 0; j < numCommands / 4; ++j) {
+                for (int g = 0; g < 4; ++g) {
+                    groups.push_back(g, commands[j % numCommandStrings]);
+                }
+            }
+        }
+        snprintf(label, sizeof(label), "Fill 4 groups of %d commands, per command", numCommands / 4);
+        print_bench_result(label, stopwatch.elapsed_ns() / (numRuns * numCommands), "ns");
+
+        stopwatch.restart();
+        for (int run = 0; run < numRuns; ++run) {
+            for (int g = 0; g < 4; ++g) {
+                for (int j = 0; j < numCommands / 4; ++j) {
+                    sink = sink + groups.get_str_idx(g, j);
+                }
+            }
+        }
+        snprintf(label, sizeof(label), "Read command j of group i, %d commands", numCommands);
+        print_bench_result(label, stopwatch.elapsed_ns() / (numRuns * numCommands), "ns");
+    }
+    groups.clear();
+
+    // The same group through the interpreter, defined once and run again.
+    // Both defining and running a group hold a deque node per command, so
+    // larger groups run out of allocator blocks
+    int const numsRunCommands[] = {100, 150};
+    for (int numCommands : numsRunCommands) {
+        std::cout.setstate(std::ios::failbit);
+        interpreter.reset();
+        interpreter.execute(PoolString<>("total IsNumber(0)"));
+        interpreter.execute(PoolString<>("add IsGroup ("));
+        for (int j = 0; j < numCommands; ++j) {
+            interpreter.execute(commands[j % numCommandStrings]);
+        }
+        interpreter.execute(PoolString<>(")"));
+
+        Stopwatch stopwatch;
+        for (int run = 0; run < numRuns; ++run) {
+            interpreter.execute(PoolString<>("add RunGroup()"));
+        }
+        double nsPerCommand = stopwatch.elapsed_ns() / (numRuns * numCommands);
+        int expected = 0;
+        for (int j = 0; j < numCommands; ++j) {
+            expected += numRuns * (j % numCommandStrings);
+        }
+        int total = interpreter.get_number_value(PoolString<>("total"));
+        std::cout.clear();
+        if (total != expected) {
+            printf("    Group of %d commands gave a wrong total\n", numCommands);
+        }
+        snprintf(label, sizeof(label), "Run group of %d commands, per command", numCommands);
+        print_bench_result(label, nsPerCommand, "ns");
+    }
+    interpreter.reset();
+}
+
+/*!
+    @brief  Times running a small group more and more times in one RunGroup,
+            and reports the highest number of strings and blocks taken at once,
+            which should not grow with the number of runs.
+*/
+void bench_run_group_repeats() {
+    print_bench_heading("run_group_repeats");
+    static Interpreter<> interpreter;
+    int const numsRuns[] = {10, 100, 1000};
+    char label[64];
+    char command[32];
+
+    std::cout.setstate(std::ios::failbit);
+    interpreter.reset();
+    interpreter.execute(PoolString<>("total IsNumber(0)"));
+    interpreter.execute(PoolString<>("count IsGroup ("));
+    interpreter.execute(PoolString<>("    If (total < 1000000) ("));
+    interpreter.execute(PoolString<>("        total IsNumber(total + 1)"));
+    interpreter.execute(PoolString<>("    )"));
+    interpreter.execute(PoolString<>(")"));
+    std::cout.clear();
+    for (int numRuns : numsRuns) {
+        snprintf(command, sizeof(command), "count RunGroup(%d)", numRuns);
+        std::cout.setstate(std::ios::failbit);
+        get_stringpool(nullptr)->reset_stat();
+        get_alloc(nullptr)->reset_stat();
+        Stopwatch stopwatch;
+        interpreter.execute(PoolString<>(command));
+        double nsPerRun = stopwatch.elapsed_ns() / numRuns;
+        std::cout.clear();
+        snprintf(label, sizeof(label), "RunGroup(%d) time per run", numRuns);
+        print_bench_result(label, nsPerRun, "ns");
+        snprintf(label, sizeof(label), "RunGroup(%d) max strings taken", numRuns);
+        print_bench_result(label, get_stringpool(nullptr)->max_num_taken(), "strings");
+        snprintf(label, sizeof(label), "RunGroup(%d) max blocks taken", numRuns);
+        int maxBlocks = 0;
+        for (int i = 0, size = 1; i < 4; ++i, size = get_alloc(nullptr)->block_size_for(size) + 1) {
+            maxBlocks += get_alloc(nullptr)->max_num_taken(size);
+        }
+        print_bench_result(label, maxBlocks, "blocks");
+    }
+    interpreter.reset();
+}
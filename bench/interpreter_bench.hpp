@@ -0,0 +1,93 @@
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <kty/containers/allocator.hpp>
+#include <kty/containers/string.hpp>
+#include <kty/containers/stringpool.hpp>
+#include <kty/interpreter.hpp>
+
+#include <bench/benchmark.hpp>
+
+using namespace kty;
+
+/*!
+    @brief  Runs every line of an example program through the interpreter.
+
+    @param  interpreter
+            The interpreter to run the program with.
+
+    @param  lines
+            The lines of the program.
+
+    @param  numLines
+            The number of lines of the program.
+*/
+template <typename Interpreter>
+void run_example(Interpreter & interpreter, std::string const * lines, int const & numLines) {
+    interpreter.reset();
+    for (int i = 0; i < numLines; ++i) {
+        interpreter.execute(PoolString<>(lines[i].c_str()));
+    }
+}
+
+/*!
+    @brief  Times whole runs of the example programs, and reports the highest
+            number of strings, string bytes and blocks they had taken at once.
+            The run time is the best of several batches of runs, to keep
+            noise from other processes out of the result.
+            The output of the programs is discarded while they run.
+*/
+void bench_interpreter_examples() {
+    print_bench_heading("interpreter_examples");
+    const int maxNumLines = 64;
+    const int numBatches = 10;
+    const int numRuns = 20;
+    char const * examples[] = {"prime", "fizz_buzz_1", "fizz_buzz_2", "fizz_buzz_3"};
+    static Interpreter<> interpreter;
+    static std::string lines[maxNumLines];
+    char label[64];
+    for (char const * example : examples) {
+        std::string path = std::string("./examples/") + example + ".kitty";
+        std::ifstream file(path.c_str());
+        int numLines = 0;
+        while (numLines < maxNumLines && std::getline(file, lines[numLines])) {
+            ++numLines;
+        }
+        std::cout.setstate(std::ios::failbit);
+        run_example(interpreter, lines, numLines);
+        get_stringpool(nullptr)->reset_stat();
+        get_alloc(nullptr)->reset_stat();
+        run_example(interpreter, lines, numLines);
+        int maxStrings = get_stringpool(nullptr)->max_num_taken();
+        int maxStringBytes = get_stringpool(nullptr)->max_bytes_taken();
+        int maxBlocks[4];
+        for (int i = 0, size = 1; i < 4; ++i, size = get_alloc(nullptr)->block_size_for(size) + 1) {
+            maxBlocks[i] = get_alloc(nullptr)->max_num_taken(size);
+        }
+        double nsPerRun = 0;
+        for (int batch = 0; batch < numBatches; ++batch) {
+            Stopwatch stopwatch;
+            for (int i = 0; i < numRuns; ++i) {
+                run_example(interpreter, lines, numLines);
+            }
+            double batchNsPerRun = stopwatch.elapsed_ns() / numRuns;
+            if (batch == 0 || batchNsPerRun < nsPerRun) {
+                nsPerRun = batchNsPerRun;
+            }
+        }
+        std::cout.clear();
+        snprintf(label, sizeof(label), "%s run time", example);
+        print_bench_result(label, nsPerRun / 1000, "us");
+        snprintf(label, sizeof(label), "%s max strings taken", example);
+        print_bench_result(label, maxStrings, "strings");
+        snprintf(label, sizeof(label), "%s max string bytes taken", example);
+        print_bench_result(label, maxStringBytes, "bytes");
+        for (int i = 0, size = 1; i < 4; ++i, size = get_alloc(nullptr)->block_size_for(size) + 1) {
+            snprintf(label, sizeof(label), "%s max %d byte blocks taken", example, get_alloc(nullptr)->block_size_for(size));
+            print_bench_result(label, maxBlocks[i], "blocks");
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <kty/containers/allocator.hpp>
+#include <kty/containers/deque.hpp>
+#include <kty/containers/instance_ref.hpp>
+#include <kty/containers/string.hpp>
+#include <kty/containers/stringpool.hpp>
+
+#include <bench/benchmark.hpp>
+#include <bench/deque_bench.hpp>
+
+using namespace kty;
+
+/*!
+    @brief  Times copying, reading and appending to pool strings
+            long enough to be stored in the pool.
+
+    @tparam String
+            The pool string type to time.
+
+    @param  name
+            The pool string type being reported.
+*/
+template <typename String>
+void time_pool_string(char const * name) {
+    const int numRuns = 20000;
+    char label[64];
+    volatile int sink = 0;
+
+    String original("a_longer_name");
+    Stopwatch stopwatch;
+    for (int run = 0; run < numRuns; ++run) {
+        String copy(original);
+        sink = sink + copy.strlen() + copy.c_str()[run % 13];
+    }
+    snprintf(label, sizeof(label), "%s copy and read", name);
+    print_bench_result(label, stopwatch.elapsed_ns() / numRuns, "ns");
+
+    stopwatch.restart();
+    for (int run = 0; run < numRuns; ++run) {
+        String copy(original);
+        copy += "_x";
+        sink = sink + copy.strlen();
+    }
+    snprintf(label, sizeof(label), "%s copy and append", name);
+    print_bench_result(label, stopwatch.elapsed_ns() / numRuns, "ns");
+}
+
+/*!
+    @brief  Compares containers that reach their allocator or string pool
+            through a function with ones that name it at compile time,
+            for object size and for speed.
+*/
+void bench_static_policies() {
+    typedef PoolString<StringPool<>, StaticPool<StringPool<>, &stringPool>> StaticString;
+    typedef Deque<int, SlabAllocator<>, StaticAlloc<SlabAllocator<>, &alloc>> StaticDeque;
+
+    print_bench_heading("static_policies");
+    print_bench_result("PoolString<> size", sizeof(PoolString<>), "bytes");
+    print_bench_result("PoolString<> with StaticPool size", sizeof(StaticString), "bytes");
+    print_bench_result("Deque<int> size", sizeof(Deque<int>), "bytes");
+    print_bench_result("Deque<int> with StaticAlloc size", sizeof(StaticDeque), "bytes");
+
+    time_pool_string<PoolString<>>("PoolString<>");
+    time_pool_string<StaticString>("PoolString<> with StaticPool");
+
+    Deque<int> deque;
+    StaticDeque staticDeque;
+    time_deque_access(deque, "Deque<int>");
+    time_deque_access(staticDeque, "Deque<int> with StaticAlloc");
+}
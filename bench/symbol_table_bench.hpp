@@ -0,0 +1,63 @@
+#pragma once
+
+#include <kty/containers/string.hpp>
+#include <kty/containers/symbol_table.hpp>
+
+#include <bench/benchmark.hpp>
+
+using namespace kty;
+
+/*!
+    @brief  Times looking up every name among a growing number of names,
+            in a symbol table and by scanning the names in order,
+            as MachineState did before it used symbol tables.
+*/
+void bench_symbol_table_scaling() {
+    print_bench_heading("symbol_table_scaling");
+    const int maxNames = 500;
+    const int numRuns = 20;
+    static SymbolTable<int, 1024> table;
+    static PoolString<> names[maxNames];
+    static int values[maxNames];
+    int const numsNames[] = {10, 50, 100, 250, 500};
+    char label[64];
+    char name[8];
+    volatile int sink = 0;
+
+    for (int numNames : numsNames) {
+        table.clear();
+        for (int i = 0; i < numNames; ++i) {
+            snprintf(name, sizeof(name), "n%d", i);
+            names[i] = name;
+            values[i] = i;
+            table.insert(names[i], i);
+        }
+
+        Stopwatch stopwatch;
+        for (int run = 0; run < numRuns; ++run) {
+            for (int i = 0; i < numNames; ++i) {
+                sink = sink + *table.find(names[i]);
+            }
+        }
+        snprintf(label, sizeof(label), "SymbolTable lookup among %d names", numNames);
+        print_bench_result(label, stopwatch.elapsed_ns() / (numRuns * numNames), "ns");
+
+        stopwatch.restart();
+        for (int run = 0; run < numRuns; ++run) {
+            for (int i = 0; i < numNames; ++i) {
+                for (int j = 0; j < numNames; ++j) {
+                    if (names[j] == names[i]) {
+                        sink = sink + values[j];
+                        break;
+                    }
+                }
+            }
+        }
+        snprintf(label, sizeof(label), "Scan lookup among %d names", numNames);
+        print_bench_result(label, stopwatch.elapsed_ns() / (numRuns * numNames), "ns");
+    }
+    table.clear();
+    for (int i = 0; i < maxNames; ++i) {
+        names[i] = PoolString<>();
+    }
+}
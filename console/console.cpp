@@ -29,7 +29,7 @@ MockArduinoLog Log;
 using namespace std;
 using namespace kty;
 
-Allocator<>         alloc;
+SlabAllocator<>     alloc;
 StringPool<>        stringPool;
 GetAllocInit<>      getAllocInit(alloc);
 GetStringPoolInit<> getStringPoolInit(stringPool);
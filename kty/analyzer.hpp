@@ -4,6 +4,7 @@
 #include <kty/containers/deque.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/string_utils.hpp>
 #include <kty/types.hpp>
 
@@ -34,7 +35,7 @@ public:
     */
     explicit Analyzer(GetAllocFunc & getAllocFunc = get_alloc, GetPoolFunc & getPoolFunc = get_stringpool) 
         : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
     }
 
     /*!
@@ -46,7 +47,7 @@ public:
         @return The result of the analysis.
     */
     AnalysisResult analyze(PoolString & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         AnalysisResult result = AnalysisResult::OKAY, tempResult;
 
         tempResult = preprocess(command);
@@ -67,7 +68,7 @@ public:
         @return The result of the preprocessing.
     */
     AnalysisResult preprocess(PoolString & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         AnalysisResult result = AnalysisResult::OKAY, tempResult;
         
         tempResult = remove_comments(command);
@@ -88,7 +89,7 @@ public:
         @return The result of removing the comments.
     */
     AnalysisResult remove_comments(PoolString & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         int commentStartIdx = command.find(';');
         if (commentStartIdx >= 0) {
             PoolString result(command.substr_ii(0, commentStartIdx));
@@ -106,8 +107,8 @@ public:
         @return The result of checking the brackets.
     */
     AnalysisResult check_bracket_matching(PoolString const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
-        Deque<char> bracketStack;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
+        Deque<char, SlabAllocator<>, GetAllocFunc, Sizes::small_deque_size> bracketStack(*getAllocFunc_);
         int len = command.strlen();
         for (int i = 0; i < len; ++i) {
             if (command[i] == '(') {
@@ -116,7 +117,7 @@ public:
             else if (command[i] == ')') {
                 // No matching '('
                 if (bracketStack.is_empty()) {
-                    Log.warning(F("%s: brackets don't match\n"), PRINT_FUNC);        
+                    KTY_LOG_WARNING(F("%s: brackets don't match\n"), PRINT_FUNC);        
                     return AnalysisResult::WARNING;
                 }
                 bracketStack.pop_back();
@@ -124,7 +125,7 @@ public:
         }
         // Too many '('
         if (!bracketStack.is_empty()) {
-            Log.warning(F("%s: brackets don't match\n"), PRINT_FUNC);        
+            KTY_LOG_WARNING(F("%s: brackets don't match\n"), PRINT_FUNC);        
             return AnalysisResult::WARNING;
         }
         return AnalysisResult::OKAY;
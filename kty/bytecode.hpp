@@ -0,0 +1,244 @@
+#pragma once
+
+#include <string.h>
+
+#include <kty/containers/symbol_table.hpp>
+#include <kty/log.hpp>
+#include <kty/sizes.hpp>
+#include <kty/types.hpp>
+
+namespace kty {
+
+// Not using enum class due to int conversion requirement for ArduinoUnit
+/*!
+    @brief  The operations of compiled commands.
+            Each is one byte, followed by its operands, if any.
+            A name operand is the binding of the name, followed by the
+            characters of the name ending in '\0', so a command never needs
+            to search for a name while its binding is current, and holds no
+            strings of the string pool.
+            A string operand is the characters of the string ending in '\0'.
+*/
+enum OpCode {
+    /** End of the command */
+    OP_END = 0,
+    /** Pushes the int operand */
+    OP_INT,
+    /** Pushes the value of the name operand */
+    OP_NAME,
+    /** Pushes the string operand */
+    OP_STR,
+    /** Applies the unary operator of the token type operand to the top value */
+    OP_UNARY,
+    /** Applies the binary operator of the token type operand to the top two values */
+    OP_BINARY,
+    /** Prints every value, then a new line */
+    OP_PRINT,
+    /** Prints the string operand on its own line */
+    OP_PRINT_STR,
+    /** Waits for the top value in milliseconds */
+    OP_WAIT,
+    /** Prints the information about the name operand */
+    OP_PRINT_INFO,
+    /** Sets the name operand to a number of the top value */
+    OP_CREATE_NUM,
+    /** Sets the name operand to an LED, from the pin and brightness values */
+    OP_CREATE_LED,
+    /** Begins the creation of the group named by the string operand */
+    OP_CREATE_GROUP,
+    /** Runs the group of the name operand the top value number of times */
+    OP_RUN_GROUP,
+    /** Moves the name operand by the top value */
+    OP_MOVE_BY,
+    /** Moves the name operand by a value, for a duration */
+    OP_MOVE_BY_FOR,
+    /** Sets the name operand to the top value */
+    OP_SET_TO,
+    /** Sets the name operand to a value, for a duration */
+    OP_SET_TO_FOR,
+    /** Begins an if block with the top value as its condition */
+    OP_IF,
+    /** Begins an else block */
+    OP_ELSE,
+    /** A command that does nothing */
+    OP_NOP,
+    /** Starts a command that opens a block, with the int operand holding
+        the index of the command that closes the block within its group,
+        or -1 if that is not known, so the block can be run or skipped
+        without reading its commands one at a time */
+    OP_BLOCK,
+};
+
+/*!
+    @brief  A value on the stack of compiled code being run.
+            A string is kept as it is to be printed, and counts as 0.
+*/
+struct Value {
+    /** The value */
+    int value = 0;
+    /** The characters of a string, or nullptr if the value is a number */
+    char const * str = nullptr;
+};
+
+/*!
+    @brief  Stack of the values of compiled code being run.
+            Holds up to Sizes::max_eval_depth values inside the object,
+            so running compiled code never allocates.
+*/
+class ValueStack {
+
+public:
+    /*!
+        @brief  Pushes a value onto the stack.
+
+        @param  value
+                The value.
+
+        @param  str
+                The characters of a string, or nullptr if the value is a number.
+
+        @return True if successful, false if the stack is full.
+    */
+    bool push(int const & value, char const * str = nullptr) {
+        if (size_ == Sizes::max_eval_depth) {
+            KTY_LOG_WARNING(F("%s: no space for more than %d values\n"), PRINT_FUNC, Sizes::max_eval_depth);
+            return false;
+        }
+        values_[size_].value = value;
+        values_[size_].str = str;
+        ++size_;
+        return true;
+    }
+
+    /*!
+        @brief  Pops the top value off the stack.
+
+        @return The top value, or 0 if the stack is empty.
+    */
+    Value pop() {
+        if (size_ == 0) {
+            return Value();
+        }
+        return values_[--size_];
+    }
+
+    /*!
+        @brief  Gets the number of values on the stack.
+
+        @return The number of values.
+    */
+    int size() const {
+        return size_;
+    }
+
+    /*!
+        @brief  Gets a value on the stack, from the bottom.
+
+        @param  i
+                The index of the value, which must be valid.
+
+        @return The value.
+    */
+    Value const & operator[](int const & i) const {
+        return values_[i];
+    }
+
+private:
+    Value values_[Sizes::max_eval_depth];
+    int size_ = 0;
+
+};
+
+/*!
+    @brief  Class that reads and writes the operands of compiled commands.
+            Operands are copied byte by byte, as they are not aligned.
+*/
+class Bytecode {
+
+public:
+    /*!
+        @brief  Checks if an operation is a command, which ends the chain of
+                if and else blocks at its scope level.
+
+        @param  op
+                The operation.
+
+        @return True if the operation is a command other than if or else,
+                false otherwise.
+    */
+    static bool is_command(OpCode const & op) {
+        return (op >= OP_PRINT && op <= OP_SET_TO_FOR) || op == OP_NOP;
+    }
+
+    /*!
+        @brief  Reads an int operand.
+
+        @param  pc
+                Where the operand starts, which is moved past it.
+
+        @return The int.
+    */
+    static int read_int(unsigned char *& pc) {
+        int value;
+        memcpy(&value, pc, sizeof(value));
+        pc += sizeof(value);
+        return value;
+    }
+
+    /*!
+        @brief  Writes an int operand.
+
+        @param  code
+                Where to write the operand.
+
+        @param  value
+                The int.
+    */
+    static void write_int(unsigned char * code, int const & value) {
+        memcpy(code, &value, sizeof(value));
+    }
+
+    /*!
+        @brief  Reads the binding of a name operand, without moving past it.
+
+        @param  pc
+                Where the operand starts.
+
+        @return The binding.
+    */
+    static SymbolBinding read_binding(unsigned char const * pc) {
+        SymbolBinding binding;
+        memcpy(&binding, pc, sizeof(binding));
+        return binding;
+    }
+
+    /*!
+        @brief  Writes the binding of a name operand.
+
+        @param  code
+                Where the operand starts.
+
+        @param  binding
+                The binding.
+    */
+    static void write_binding(unsigned char * code, SymbolBinding const & binding) {
+        memcpy(code, &binding, sizeof(binding));
+    }
+
+    /*!
+        @brief  Reads a string operand, or the characters of a name operand.
+
+        @param  pc
+                Where the characters start, which is moved past them.
+
+        @return The characters, ending in '\0'.
+    */
+    static char const * read_str(unsigned char *& pc) {
+        char const * str = reinterpret_cast<char const *>(pc);
+        pc += ::strlen(str) + 1;
+        return str;
+    }
+
+};
+
+} // namespace kty
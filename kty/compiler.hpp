@@ -0,0 +1,265 @@
+#pragma once
+
+#include <kty/bytecode.hpp>
+#include <kty/containers/deque.hpp>
+#include <kty/containers/string.hpp>
+#include <kty/containers/symbol_table.hpp>
+#include <kty/log.hpp>
+#include <kty/sizes.hpp>
+#include <kty/string_utils.hpp>
+#include <kty/token.hpp>
+#include <kty/types.hpp>
+
+namespace kty {
+
+/*!
+    @brief  Class that compiles parsed commands into bytecode,
+            so that they can be run many times without being tokenized
+            and parsed again.
+            Every command that is run is compiled first.
+*/
+template <typename Token = Token<>, typename PoolString = PoolString<>>
+class Compiler {
+
+public:
+    /*!
+        @brief  Constructor for the compiler.
+    */
+    Compiler() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+    }
+
+    /*!
+        @brief  Compiles a command.
+
+        @param  command
+                The parsed command, with its tokens in postfix notation.
+
+        @param  opensBlock
+                Whether the command opens a block, so that the code starts
+                with a place for the index of the command that closes it.
+
+        @return The number of bytes of bytecode, which can be read from code(),
+                or -1 if the bytecode does not fit in Sizes::max_code_length bytes,
+                or needs more than Sizes::max_eval_depth values on the stack.
+    */
+    int compile(Deque<Token> const & command, bool const & opensBlock = false) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        size_ = 0;
+        depth_ = 0;
+        fits_ = true;
+        if (opensBlock) {
+            emit_op(OP_BLOCK);
+            emit_int(-1);
+        }
+        if (command.is_empty()) {
+            emit_op(OP_NOP);
+        }
+        else if (command.back().is_if()) {
+            emit_expression(command, 0, command.size() - 1);
+            emit_op(OP_IF);
+        }
+        else if (command.back().is_else()) {
+            emit_op(OP_ELSE);
+        }
+        else if (command.back().is_print()) {
+            emit_expression(command, 0, command.size() - 1);
+            emit_op(OP_PRINT);
+        }
+        else if (command.back().is_wait()) {
+            emit_expression(command, 0, command.size() - 1);
+            emit_op(OP_WAIT);
+        }
+        else if (command.front().is_name()) {
+            PoolString const & name = command.front().get_value();
+            if (command.size() == 1) {
+                emit_op(OP_PRINT_INFO);
+                emit_name(name);
+            }
+            else if (command.back().is_create_group()) {
+                emit_op(OP_CREATE_GROUP);
+                emit_str(name);
+            }
+            else {
+                // The name is followed by the arguments, then the function
+                emit_expression(command, 1, command.size() - 1);
+                emit_op(function_op(command.back()));
+                emit_name(name);
+            }
+        }
+        else if (command.front().is_string()) {
+            emit_op(OP_PRINT_STR);
+            emit_str(command.front().get_value());
+        }
+        else {
+            emit_op(OP_NOP);
+        }
+        emit_op(OP_END);
+        return fits_ ? size_ : -1;
+    }
+
+    /*!
+        @brief  Gets the bytecode of the last command compiled.
+
+        @return A pointer to the bytecode, which can be run in place.
+    */
+    unsigned char * code() {
+        return code_;
+    }
+
+private:
+    /*!
+        @brief  Gets the operation for the function that ends a command
+                starting with a name.
+                Any function that is not one of these runs the group of the name.
+
+        @param  function
+                The function token.
+
+        @return The operation.
+    */
+    static OpCode function_op(Token const & function) {
+        return function.is_create_num() ? OP_CREATE_NUM :
+               function.is_create_led() ? OP_CREATE_LED :
+               function.is_move_by() ? OP_MOVE_BY :
+               function.is_move_by_for() ? OP_MOVE_BY_FOR :
+               function.is_set_to() ? OP_SET_TO :
+               function.is_set_to_for() ? OP_SET_TO_FOR : OP_RUN_GROUP;
+    }
+
+    /*!
+        @brief  Emits the bytecode that evaluates part of a postfix expression,
+                leaving its values on the stack.
+
+        @param  command
+                The parsed command.
+
+        @param  first
+                The index of the first token of the expression.
+
+        @param  last
+                The index after the last token of the expression.
+    */
+    void emit_expression(Deque<Token> const & command, int const & first, int const & last) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int i = 0;
+        for (typename Deque<Token>::ConstIterator it = command.cbegin(); it != command.cend() && i < last; ++it, ++i) {
+            if (i < first) {
+                continue;
+            }
+            Token const & token = *it;
+            if (token.is_unary_operator()) {
+                emit_op(OP_UNARY);
+                emit_byte(token.get_type());
+            }
+            else if (token.is_operator()) {
+                emit_op(OP_BINARY);
+                emit_byte(token.get_type());
+                --depth_;
+            }
+            else if (token.is_num_val()) {
+                emit_op(OP_INT);
+                emit_int(str_to_int(token.get_value()));
+                ++depth_;
+            }
+            else if (token.is_name()) {
+                emit_op(OP_NAME);
+                emit_name(token.get_value());
+                ++depth_;
+            }
+            // Everything else is kept as it is, to be printed
+            else {
+                emit_op(OP_STR);
+                emit_str(token.get_value());
+                ++depth_;
+            }
+            if (depth_ > Sizes::max_eval_depth) {
+                fits_ = false;
+            }
+        }
+    }
+
+    /*!
+        @brief  Emits an operation.
+
+        @param  op
+                The operation.
+    */
+    void emit_op(OpCode const & op) {
+        emit_byte(op);
+    }
+
+    /*!
+        @brief  Emits a single byte.
+
+        @param  byte
+                The byte.
+    */
+    void emit_byte(int const & byte) {
+        if (size_ + 1 > Sizes::max_code_length) {
+            fits_ = false;
+            return;
+        }
+        code_[size_++] = (unsigned char)byte;
+    }
+
+    /*!
+        @brief  Emits an int operand.
+
+        @param  value
+                The int.
+    */
+    void emit_int(int const & value) {
+        if (size_ + (int)sizeof(int) > Sizes::max_code_length) {
+            fits_ = false;
+            return;
+        }
+        Bytecode::write_int(code_ + size_, value);
+        size_ += sizeof(int);
+    }
+
+    /*!
+        @brief  Emits a string operand.
+
+        @param  str
+                The string.
+    */
+    void emit_str(PoolString const & str) {
+        int len = str.strlen();
+        if (size_ + len + 1 > Sizes::max_code_length) {
+            fits_ = false;
+            return;
+        }
+        memcpy(code_ + size_, str.c_str(), len + 1);
+        size_ += len + 1;
+    }
+
+    /*!
+        @brief  Emits a name operand, with a binding to no entry,
+                so that the name is bound the first time it is run.
+
+        @param  name
+                The name.
+    */
+    void emit_name(PoolString const & name) {
+        if (size_ + (int)sizeof(SymbolBinding) > Sizes::max_code_length) {
+            fits_ = false;
+            return;
+        }
+        Bytecode::write_binding(code_ + size_, SymbolBinding());
+        size_ += sizeof(SymbolBinding);
+        emit_str(name);
+    }
+
+    /** The bytecode of the last command compiled */
+    unsigned char code_[Sizes::max_code_length];
+    /** The number of bytes of bytecode */
+    int size_ = 0;
+    /** The number of values on the stack after the bytecode so far */
+    int depth_ = 0;
+    /** Whether the bytecode has fit so far */
+    bool fits_ = true;
+
+};
+
+} // namespace kty
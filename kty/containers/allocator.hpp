@@ -1,5 +1,7 @@
 #pragma once
 
+#include <kty/containers/instance_ref.hpp>
+#include <kty/log.hpp>
 #include <kty/sizes.hpp>
 #include <kty/types.hpp>
 
@@ -14,13 +16,20 @@ template <int N = Sizes::alloc_size, int B = Sizes::alloc_block_size>
 class Allocator {
 
 public:
+    /** The largest number of bytes that can be allocated at once. */
+    static const int max_block_size = B;
+
     /*!
         @brief  Constructor for the allocator.
     */
     Allocator() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         memset(reinterpret_cast<void *>(pool_), 0, N * B);
-        memset(reinterpret_cast<void *>(refCount_), false, N * sizeof(int));
+        // Chain every block into the free list, lowest index first
+        for (int i = 0; i < N; ++i) {
+            set_next_free(i, i + 1 < N ? i + 1 : -1);
+        }
+        freeHead_ = 0;
         numTaken_ = 0;
         maxNumTaken_ = 0;
     }
@@ -29,24 +38,43 @@ public:
         @brief  Prints stats about the allocator.
     */
     void stat() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Log.notice(F("%s: num taken = %d, max num taken = %d\n"), PRINT_FUNC, numTaken_, maxNumTaken_);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_NOTICE(F("%s: num taken = %d, max num taken = %d\n"), PRINT_FUNC, numTaken_, maxNumTaken_);
     }
 
     /*!
         @brief  Resets the stats about the allocator.
     */
     void reset_stat() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         maxNumTaken_ = numTaken_;
     }
 
+    /*!
+        @brief  Gets the number of blocks currently taken.
+
+        @return The number of blocks currently taken.
+    */
+    int num_taken() const {
+        return numTaken_;
+    }
+
+    /*!
+        @brief  Gets the highest number of blocks taken at once since
+                construction or the last call to reset_stat().
+
+        @return The highest number of blocks taken at once.
+    */
+    int max_num_taken() const {
+        return maxNumTaken_;
+    }
+
     /*!
         @brief  Prints the addresses used by the allocator
     */
     void dump_addresses() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Log.notice(F("%s: Pool addresses = %d to %d\n"), PRINT_FUNC, (intptr_t)pool_, (intptr_t)(pool_ + N * B - 1));
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_NOTICE(F("%s: Pool addresses = %d to %d\n"), PRINT_FUNC, (intptr_t)pool_, (intptr_t)(pool_ + N * B - 1));
     }
 
     /*!
@@ -59,7 +87,7 @@ public:
     */
     template <typename T>
     bool owns(T * addr) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         char* addr_ = (char *)addr;
         return addr_ - pool_ >= 0 && addr_ - pool_ < N * B;
     }
@@ -70,7 +98,7 @@ public:
         @return The number of available blocks left in the pool.
     */
     int available() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return N - numTaken_;
     }
 
@@ -83,7 +111,7 @@ public:
         @return The address of the memory at that index.
     */
     void * get_addr(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return (void *)(pool_ + (B * idx));
     }
 
@@ -97,7 +125,7 @@ public:
     */
     template <typename T>
     int get_idx(T * addr) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return ((char *)addr - pool_) / B;
     }
 
@@ -112,14 +140,14 @@ public:
     */
     template <typename T>
     int ref_count(T * addr) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         char * addr_ = (char *)addr;
         if (!owns(addr_)) {
-            Log.warning(F("%s: idx %d is not valid\n"), PRINT_FUNC, get_idx(addr));
+            KTY_LOG_WARNING(F("%s: idx %d is not valid\n"), PRINT_FUNC, get_idx(addr));
             return -1;
         }
         int idx = get_idx(addr);
-        return refCount_[idx];
+        return is_free(idx) ? 0 : refCount_[idx];
     }
 
     /*!
@@ -133,13 +161,16 @@ public:
     */
     template <typename T>
     int inc_ref_count(T * addr) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         char * addr_ = (char *)addr;
         if (!owns(addr_)) {
-            Log.warning(F("%s: idx %d is not valid\n"), PRINT_FUNC, get_idx(addr));
+            KTY_LOG_WARNING(F("%s: idx %d is not valid\n"), PRINT_FUNC, get_idx(addr));
             return -1;
         }
         int idx = get_idx(addr);
+        if (is_free(idx)) {
+            take_free(idx);
+        }
         ++refCount_[idx];
         return refCount_[idx];
     }
@@ -147,9 +178,8 @@ public:
     /*!
         @brief  Decreases the reference count of a memory address.
                 If this operation decreases the reference count to 0,
-                it is not deallocated.
-                To ensure that a decrease to 0 deallocates the address,
-                call deallocate().
+                the block is returned to the pool, the same as a final
+                call to deallocate().
 
         @param  addr
                 The address to look up.
@@ -159,48 +189,69 @@ public:
     */
     template <typename T>
     int dec_ref_count(T * addr) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         char * addr_ = (char *)addr;
         if (!owns(addr_)) {
-            Log.warning(F("%s: idx %d is not valid\n"), PRINT_FUNC, get_idx(addr));
+            KTY_LOG_WARNING(F("%s: idx %d is not valid\n"), PRINT_FUNC, get_idx(addr));
             return -1;
         }
         int idx = get_idx(addr);
+        if (is_free(idx)) {
+            KTY_LOG_WARNING(F("%s: idx %d is already free\n"), PRINT_FUNC, idx);
+            return 0;
+        }
         --refCount_[idx];
+        if (refCount_[idx] == 0) {
+            release(idx);
+            return 0;
+        }
         return refCount_[idx];
     }
 
     /*!
         @brief  Allocates a single block of memory from the pool.
                 Zeroes out memory before handing it out.
+                Blocks are taken from the head of the free list,
+                so allocation does not depend on how full the pool is.
 
         @return A pointer to a block of memory.
                 If no memory is available, nullptr is returned.
     */
     void* allocate() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (numTaken_ == N) {
-            Log.warning(F("%s: Could not allocate new block from pool\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (freeHead_ == -1) {
+            KTY_LOG_WARNING(F("%s: Could not allocate new block from pool\n"), PRINT_FUNC);
             return nullptr;
         }
-        void * addr = nullptr;
-        for (int i = 0; i < N; ++i) {
-            if (refCount_[i] == 0) {
-                ++refCount_[i];
-                ++numTaken_;
-                Log.verbose(F("%s: Allocating %d\n"), PRINT_FUNC, i);
-                if (numTaken_ > maxNumTaken_) {
-                    maxNumTaken_ = numTaken_;
-                    Log.verbose(F("%s: new maxNumTaken %d\n"), PRINT_FUNC, maxNumTaken_);
-                }
-                addr = get_addr(i);
-                memset(addr, 0, B);
-                break;
-            }
-        }
+        int idx = freeHead_;
+        take_free(idx);
+        ++refCount_[idx];
+        KTY_LOG_VERBOSE(F("%s: Allocating %d\n"), PRINT_FUNC, idx);
+        void * addr = get_addr(idx);
+        memset(addr, 0, B);
         return addr;
     }
 
+    /*!
+        @brief  Allocates a single block of memory from the pool,
+                checking that the requested size fits in a block.
+
+        @param  size
+                The number of bytes required.
+
+        @return A pointer to a block of memory.
+                If no memory is available, or the size is larger than
+                a block, nullptr is returned.
+    */
+    void* allocate(int const & size) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (size > B) {
+            KTY_LOG_WARNING(F("%s: %d bytes do not fit in a %d byte block\n"), PRINT_FUNC, size, B);
+            return nullptr;
+        }
+        return allocate();
+    }
+
     /*!
         @brief  Returns a single block of memory to the pool.
                 This does not call the destructor on the data stored at the block.
@@ -214,39 +265,419 @@ public:
     */
     template <typename T>
     bool deallocate(T * addr) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         char * addr_ = (char *)addr;
         int idx = get_idx(addr_);
         if (!owns(addr_)) {
-            Log.warning(F("%s: index %d given to deallocate did not come from pool\n"), PRINT_FUNC, idx);
+            KTY_LOG_WARNING(F("%s: index %d given to deallocate did not come from pool\n"), PRINT_FUNC, idx);
             return false;
         }
-        if (refCount_[idx] > 0) {
+        if (!is_free(idx)) {
             --refCount_[idx];
         }
         else {
-            Log.warning(F("%s: idx %d given to deallocate has already been previously deallocated\n"), PRINT_FUNC, idx);
+            KTY_LOG_WARNING(F("%s: idx %d given to deallocate has already been previously deallocated\n"), PRINT_FUNC, idx);
             return false;
         }
         if (refCount_[idx] == 0) {
-            Log.verbose(F("%s: deallocated idx %d successfully\n"), PRINT_FUNC, idx);
-            --numTaken_;
+            KTY_LOG_VERBOSE(F("%s: deallocated idx %d successfully\n"), PRINT_FUNC, idx);
+            release(idx);
             return true;
         }
         else {
-            Log.verbose(F("%s: idx %d is not the last reference, not deallocating\n"), PRINT_FUNC, idx);
+            KTY_LOG_VERBOSE(F("%s: idx %d is not the last reference, not deallocating\n"), PRINT_FUNC, idx);
             return true;
         }
     }
 
 private:
-    char pool_[N * B];
+    /*!
+        @brief  Removes a block from the free list and marks it as taken.
+
+        @param  idx
+                The index of the free block.
+    */
+    void take_free(int const & idx) {
+        if (freeHead_ == idx) {
+            freeHead_ = next_free(idx);
+        }
+        else {
+            // Only reached when reviving a block through inc_ref_count()
+            int prev = freeHead_;
+            while (prev != -1 && next_free(prev) != idx) {
+                prev = next_free(prev);
+            }
+            if (prev != -1) {
+                set_next_free(prev, next_free(idx));
+            }
+        }
+        refCount_[idx] = 0;
+        ++numTaken_;
+        if (numTaken_ > maxNumTaken_) {
+            maxNumTaken_ = numTaken_;
+            KTY_LOG_VERBOSE(F("%s: new maxNumTaken %d\n"), PRINT_FUNC, maxNumTaken_);
+        }
+    }
+
+    /*!
+        @brief  Pushes a block whose reference count has reached 0
+                onto the front of the free list.
+
+        @param  idx
+                The index of the block.
+    */
+    void release(int const & idx) {
+        set_next_free(idx, freeHead_);
+        freeHead_ = idx;
+        --numTaken_;
+    }
+
+    /*!
+        @brief  Checks if a block is in the free list.
+
+        @param  idx
+                The index of the block.
+
+        @return True if the block is free, false otherwise.
+    */
+    bool is_free(int const & idx) const {
+        return refCount_[idx] < 0;
+    }
+
+    /*!
+        @brief  Gets the index of the free block after a free block.
+
+        @param  idx
+                The index of the free block.
+
+        @return The index of the next free block, -1 at the end of the list.
+    */
+    int next_free(int const & idx) const {
+        return -2 - refCount_[idx];
+    }
+
+    /*!
+        @brief  Puts a block in the free list, in front of another free block.
+
+        @param  idx
+                The index of the block.
+
+        @param  next
+                The index of the next free block, -1 at the end of the list.
+    */
+    void set_next_free(int const & idx, int const & next) {
+        refCount_[idx] = -2 - next;
+    }
+
+    /** Aligned for any type, so that blocks whose size is a multiple of the alignment of a type can hold it */
+    alignas(alignof(max_align_t)) char pool_[N * B];
+    /** The reference count of each taken block. A free block holds the index
+        of the next free block instead, as -2 - index, so it is always negative */
     int refCount_[N];
+    /** Index of the first free block, -1 if the pool is full */
+    int freeHead_;
     int numTaken_;
     int maxNumTaken_;
 
 };
 
+/*!
+    @brief  Class that performs allocation and deallocation of memory blocks
+            of several sizes.
+            Holds one Allocator per size class, each with its own number of blocks,
+            and serves every request from the smallest class that fits it.
+            Block sizes must be given in increasing order.
+*/
+template <int N0 = Sizes::slab_size_0, int B0 = Sizes::slab_block_size_0,
+          int N1 = Sizes::slab_size_1, int B1 = Sizes::slab_block_size_1,
+          int N2 = Sizes::slab_size_2, int B2 = Sizes::slab_block_size_2,
+          int N3 = Sizes::slab_size_3, int B3 = Sizes::slab_block_size_3>
+class SlabAllocator {
+
+public:
+    /** The largest number of bytes that can be allocated at once. */
+    static const int max_block_size = B3;
+
+    /*!
+        @brief  Constructor for the slab allocator.
+    */
+    SlabAllocator() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        static_assert(B0 < B1 && B1 < B2 && B2 < B3, "SlabAllocator block sizes must be given in increasing order.");
+    }
+
+    /*!
+        @brief  Gets the block size of the class that serves a request.
+
+        @param  size
+                The number of bytes required.
+
+        @return The block size of the smallest class that fits the request.
+                If no class is large enough, -1 is returned.
+    */
+    static int block_size_for(int const & size) {
+        return size <= B0 ? B0 :
+               size <= B1 ? B1 :
+               size <= B2 ? B2 :
+               size <= B3 ? B3 : -1;
+    }
+
+    /*!
+        @brief  Prints stats about each class of the allocator.
+    */
+    void stat() const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_NOTICE(F("%s: %d byte blocks: num taken = %d, max num taken = %d\n"), PRINT_FUNC, B0, class0_.num_taken(), class0_.max_num_taken());
+        KTY_LOG_NOTICE(F("%s: %d byte blocks: num taken = %d, max num taken = %d\n"), PRINT_FUNC, B1, class1_.num_taken(), class1_.max_num_taken());
+        KTY_LOG_NOTICE(F("%s: %d byte blocks: num taken = %d, max num taken = %d\n"), PRINT_FUNC, B2, class2_.num_taken(), class2_.max_num_taken());
+        KTY_LOG_NOTICE(F("%s: %d byte blocks: num taken = %d, max num taken = %d\n"), PRINT_FUNC, B3, class3_.num_taken(), class3_.max_num_taken());
+    }
+
+    /*!
+        @brief  Resets the stats about each class of the allocator.
+    */
+    void reset_stat() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        class0_.reset_stat();
+        class1_.reset_stat();
+        class2_.reset_stat();
+        class3_.reset_stat();
+    }
+
+    /*!
+        @brief  Gets the number of blocks currently taken, across all classes.
+
+        @return The number of blocks currently taken.
+    */
+    int num_taken() const {
+        return class0_.num_taken() + class1_.num_taken() + class2_.num_taken() + class3_.num_taken();
+    }
+
+    /*!
+        @brief  Gets the number of blocks currently taken in the class
+                that serves a request.
+
+        @param  size
+                The number of bytes of the request.
+
+        @return The number of blocks currently taken in that class.
+                If no class is large enough, -1 is returned.
+    */
+    int num_taken(int const & size) const {
+        return size <= B0 ? class0_.num_taken() :
+               size <= B1 ? class1_.num_taken() :
+               size <= B2 ? class2_.num_taken() :
+               size <= B3 ? class3_.num_taken() : -1;
+    }
+
+    /*!
+        @brief  Gets the highest number of blocks taken at once in the class
+                that serves a request, since construction or the last call
+                to reset_stat().
+
+        @param  size
+                The number of bytes of the request.
+
+        @return The highest number of blocks taken at once in that class.
+                If no class is large enough, -1 is returned.
+    */
+    int max_num_taken(int const & size) const {
+        return size <= B0 ? class0_.max_num_taken() :
+               size <= B1 ? class1_.max_num_taken() :
+               size <= B2 ? class2_.max_num_taken() :
+               size <= B3 ? class3_.max_num_taken() : -1;
+    }
+
+    /*!
+        @brief  Prints the addresses used by each class of the allocator.
+    */
+    void dump_addresses() const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        class0_.dump_addresses();
+        class1_.dump_addresses();
+        class2_.dump_addresses();
+        class3_.dump_addresses();
+    }
+
+    /*!
+        @brief  Checks if an address is owned by this allocator.
+
+        @param  addr
+                The address to check.
+
+        @return True if the address is owned by this allocator, false otherwise.
+    */
+    template <typename T>
+    bool owns(T * addr) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return class0_.owns(addr) || class1_.owns(addr) || class2_.owns(addr) || class3_.owns(addr);
+    }
+
+    /*!
+        @brief  Check the number of available blocks left, across all classes.
+
+        @return The number of available blocks left.
+    */
+    int available() const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return class0_.available() + class1_.available() + class2_.available() + class3_.available();
+    }
+
+    /*!
+        @brief  Check the number of available blocks left in the class
+                that serves a request.
+
+        @param  size
+                The number of bytes of the request.
+
+        @return The number of available blocks left in that class.
+                If no class is large enough, 0 is returned.
+    */
+    int available(int const & size) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return size <= B0 ? class0_.available() :
+               size <= B1 ? class1_.available() :
+               size <= B2 ? class2_.available() :
+               size <= B3 ? class3_.available() : 0;
+    }
+
+    /*!
+        @brief  Gets the reference count of a memory address.
+
+        @param  addr
+                The address to look up.
+        
+        @return The number of references to that address.
+                If the address is invalid, -1 is returned.
+    */
+    template <typename T>
+    int ref_count(T * addr) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (class0_.owns(addr)) {
+            return class0_.ref_count(addr);
+        }
+        if (class1_.owns(addr)) {
+            return class1_.ref_count(addr);
+        }
+        if (class2_.owns(addr)) {
+            return class2_.ref_count(addr);
+        }
+        return class3_.ref_count(addr);
+    }
+
+    /*!
+        @brief  Increases reference count of a memory address.
+
+        @param  addr
+                The address to look up.
+
+        @return The new reference count of the memory address.
+                If the address is invalid, -1 is returned.
+    */
+    template <typename T>
+    int inc_ref_count(T * addr) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (class0_.owns(addr)) {
+            return class0_.inc_ref_count(addr);
+        }
+        if (class1_.owns(addr)) {
+            return class1_.inc_ref_count(addr);
+        }
+        if (class2_.owns(addr)) {
+            return class2_.inc_ref_count(addr);
+        }
+        return class3_.inc_ref_count(addr);
+    }
+
+    /*!
+        @brief  Decreases the reference count of a memory address.
+                If this operation decreases the reference count to 0,
+                the block is returned to its class.
+
+        @param  addr
+                The address to look up.
+
+        @return The new reference count of the memory address.
+                If the address is invalid, -1 is returned.
+    */
+    template <typename T>
+    int dec_ref_count(T * addr) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (class0_.owns(addr)) {
+            return class0_.dec_ref_count(addr);
+        }
+        if (class1_.owns(addr)) {
+            return class1_.dec_ref_count(addr);
+        }
+        if (class2_.owns(addr)) {
+            return class2_.dec_ref_count(addr);
+        }
+        return class3_.dec_ref_count(addr);
+    }
+
+    /*!
+        @brief  Allocates a single block of memory from the smallest class
+                that fits the requested size.
+                Zeroes out memory before handing it out.
+
+        @param  size
+                The number of bytes required.
+                Default is the largest block size.
+
+        @return A pointer to a block of memory.
+                If no memory is available in that class, or the size is
+                larger than every class, nullptr is returned.
+    */
+    void* allocate(int const & size = B3) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (size <= B0) {
+            return class0_.allocate();
+        }
+        if (size <= B1) {
+            return class1_.allocate();
+        }
+        if (size <= B2) {
+            return class2_.allocate();
+        }
+        if (size <= B3) {
+            return class3_.allocate();
+        }
+        KTY_LOG_WARNING(F("%s: %d bytes is larger than the largest block size %d\n"), PRINT_FUNC, size, B3);
+        return nullptr;
+    }
+
+    /*!
+        @brief  Returns a single block of memory to the class it came from.
+                This does not call the destructor on the data stored at the block.
+
+        @param  addr
+                A pointer to a block of memory to be returned.
+
+        @return True if the deallocation was successful, false otherwise.
+    */
+    template <typename T>
+    bool deallocate(T * addr) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (class0_.owns(addr)) {
+            return class0_.deallocate(addr);
+        }
+        if (class1_.owns(addr)) {
+            return class1_.deallocate(addr);
+        }
+        if (class2_.owns(addr)) {
+            return class2_.deallocate(addr);
+        }
+        return class3_.deallocate(addr);
+    }
+
+private:
+    Allocator<N0, B0> class0_;
+    Allocator<N1, B1> class1_;
+    Allocator<N2, B2> class2_;
+    Allocator<N3, B3> class3_;
+
+};
+
 /*!
     @brief  Returns a pointer to an allocator.
 
@@ -256,18 +687,29 @@ private:
 
     @return A pointer to an allocator.
 */
-Allocator<Sizes::alloc_size, Sizes::alloc_block_size> * get_alloc(Allocator<Sizes::alloc_size, Sizes::alloc_block_size> * ptr = nullptr) {
-    static Allocator<Sizes::alloc_size, Sizes::alloc_block_size> * alloc;
+SlabAllocator<> * get_alloc(SlabAllocator<> * ptr = nullptr) {
+    static SlabAllocator<> * alloc;
     if (ptr != nullptr) {
         alloc = ptr;
     }
     return alloc;
 }
 
+/*!
+    @brief  Specialisation of DefaultGetFunc that makes get_alloc the function
+            used by containers that are not told where their allocator is.
+*/
+template <>
+struct DefaultGetFunc<decltype(get_alloc)> {
+    static decltype(get_alloc) & get() {
+        return get_alloc;
+    }
+};
+
 /*!
     @brief  Class to perform setup of the get_alloc function at the global scope.
 */
-template <typename Alloc = Allocator<Sizes::alloc_size, Sizes::alloc_block_size>>
+template <typename Alloc = SlabAllocator<>>
 class GetAllocInit {
 
 public:
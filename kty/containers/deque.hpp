@@ -1,44 +1,164 @@
 #pragma once
 
 #include <kty/containers/allocator.hpp>
+#include <kty/containers/instance_ref.hpp>
+#include <kty/log.hpp>
 #include <kty/sizes.hpp>
 #include <kty/types.hpp>
+#include <kty/utils.hpp>
 
 namespace kty {
 
+/*!
+    @brief  Class holding a fixed number of node sized blocks inside its owner,
+            which are handed out before any blocks are taken from an allocator.
+            Blocks are zeroed when they are handed out, as allocator blocks are.
+*/
+template <typename Node, int N>
+class InlineBlocks {
+
+public:
+    /*!
+        @brief  Constructor.
+    */
+    InlineBlocks() {
+        static_assert(N <= 16, "InlineBlocks<Node, N> can hold at most 16 blocks.");
+    }
+
+    /*!
+        @brief  Takes a free block.
+
+        @return A pointer to the block, or nullptr if all blocks are taken.
+    */
+    void * allocate() {
+        for (int i = 0; i < N; ++i) {
+            if ((taken_ & (1u << i)) == 0) {
+                taken_ |= 1u << i;
+                memset(blocks_ + i * sizeof(Node), 0, sizeof(Node));
+                return blocks_ + i * sizeof(Node);
+            }
+        }
+        return nullptr;
+    }
+
+    /*!
+        @brief  Gives a block back.
+
+        @param  ptr
+                The block, which must be owned by this object.
+
+        @return True if the block was taken before, false otherwise.
+    */
+    bool deallocate(void * ptr) {
+        unsigned int bit = 1u << ((static_cast<unsigned char *>(ptr) - blocks_) / sizeof(Node));
+        bool wasTaken = (taken_ & bit) != 0;
+        taken_ &= ~bit;
+        return wasTaken;
+    }
+
+    /*!
+        @brief  Checks if a block belongs to this object.
+
+        @param  ptr
+                The block.
+
+        @return True if the block is one of this object's blocks, false otherwise.
+    */
+    bool owns(void const * ptr) const {
+        return ptr >= blocks_ && ptr < blocks_ + N * sizeof(Node);
+    }
+
+    /*!
+        @brief  Gets the number of blocks that are taken.
+
+        @return The number of blocks taken.
+    */
+    int num_taken() const {
+        int num = 0;
+        for (int i = 0; i < N; ++i) {
+            num += (taken_ >> i) & 1u;
+        }
+        return num;
+    }
+
+private:
+    alignas(Node) unsigned char blocks_[N * sizeof(Node)];
+    unsigned int taken_ = 0;
+};
+
+/*!
+    @brief  Specialisation of InlineBlocks that holds no blocks,
+            so that it takes no space in its owner.
+*/
+template <typename Node>
+class InlineBlocks<Node, 0> {
+
+public:
+    void * allocate() {
+        return nullptr;
+    }
+
+    bool deallocate(void *) {
+        return false;
+    }
+
+    bool owns(void const *) const {
+        return false;
+    }
+
+    int num_taken() const {
+        return 0;
+    }
+};
+
 /*!
     @brief  Double-ended queue.
             Provides quick insertion and deletion at both ends,
-            but at the expense of slow random access. 
-            Implemented as a circular doubly linked list with a dummy head node.
+            but at the expense of slow random access.
+            Implemented as a circular doubly linked list, closed by a head
+            link stored inside the deque, so an empty deque takes no blocks.
+            The first N nodes come from blocks stored inside the deque too,
+            so small deques take no blocks either.
+            The allocator is either given directly, reached through a function,
+            or named at compile time with a StaticAlloc policy as GetAllocFunc.
 */
-template <typename T, typename Alloc = Allocator<Sizes::alloc_size, Sizes::alloc_block_size>, typename GetAllocFunc = decltype(get_alloc)>
-class Deque {
+template <typename T, typename Alloc = SlabAllocator<>, typename GetAllocFunc = decltype(get_alloc), int N = 0>
+class Deque : private InstanceRef<Alloc, GetAllocFunc> {
+
+    /** The type referring to the allocator for this deque */
+    typedef InstanceRef<Alloc, GetAllocFunc> AllocRef;
 
 public:
     /** The type of value stored in the deque */
     typedef T value_t;
 
+    /*!
+        @brief  The links between nodes of the deque.
+                The head of the deque has only these, and no value.
+    */
+    struct Link {
+        /** The link after this one */
+        Link* next;
+        /** The link before this one */
+        Link* prev;
+    };
+
     /*!
         @brief  The node structure that makes up the deque.
     */
-    struct Node {
+    struct Node : Link {
         /** The value stored in the node */
         value_t value;
-        /** The node after this one */
-        Node* next;
-        /** The node before this one */
-        Node* prev;
     };
 
     /*!
         @brief  The iterator class for the deque.
     */
     class Iterator {
-    
+
     public:
         /** Friend class declaration such that deque can access its internal pointers */
-        friend class Deque<value_t, Alloc>;
+        friend class Deque;
 
         /*!
             @brief  Constructor.
@@ -46,7 +166,7 @@ public:
             @param  ptr
                     The pointer to store in the iterator.
         */
-        explicit Iterator(Node * ptr)
+        explicit Iterator(Link * ptr)
             : ptr_(ptr) {
         }
 
@@ -100,7 +220,7 @@ public:
             @return A reference to the value pointed to by the iterator.
         */
         value_t & operator*() {
-            return ptr_->value;
+            return static_cast<Node *>(ptr_)->value;
         }
 
         /*!
@@ -109,7 +229,7 @@ public:
             @return A pointer to the value pointed to by the iterator.
         */
         value_t * operator->() {
-            return &(ptr_->value);
+            return &(static_cast<Node *>(ptr_)->value);
         }
 
         /*!
@@ -139,7 +259,7 @@ public:
         }
 
     private:
-        Node* ptr_;
+        Link* ptr_;
     };
 
     /*!
@@ -148,10 +268,10 @@ public:
                 the values it points to cannot be changed.
     */
     class ConstIterator {
-    
+
     public:
         /** Friend class declaration such that deque can access internal pointers */
-        friend class Deque<value_t, Alloc>;
+        friend class Deque;
 
         /*!
             @brief  Constructor.
@@ -159,8 +279,8 @@ public:
             @param  ptr
                     The pointer to store in the iterator.
         */
-        explicit ConstIterator(Node const * ptr)
-            : ptr_(const_cast<Node *>(ptr)) {
+        explicit ConstIterator(Link const * ptr)
+            : ptr_(const_cast<Link *>(ptr)) {
         }
 
         /*!
@@ -179,7 +299,7 @@ public:
             @return A copy of the iterator in its pre-decremented state.
         */
         ConstIterator operator--(int) {
-            Iterator temp(ptr_);
+            ConstIterator temp(ptr_);
             ptr_ = ptr_->prev;
             return temp;
         }
@@ -202,7 +322,7 @@ public:
             @return A copy of the iterator in its pre-incremented state.
         */
         ConstIterator operator++(int) {
-            Iterator temp(ptr_);
+            ConstIterator temp(ptr_);
             ptr_ = ptr_->next;
             return temp;
         }
@@ -213,7 +333,7 @@ public:
             @return A const reference to the value pointed to by the iterator.
         */
         value_t const & operator*() const {
-            return ptr_->value;
+            return static_cast<Node *>(ptr_)->value;
         }
 
         /*!
@@ -222,7 +342,7 @@ public:
             @return A const pointer to the value pointed to by the iterator.
         */
         value_t const * operator->() const {
-            return &(ptr_->value);
+            return &(static_cast<Node *>(ptr_)->value);
         }
 
         /*!
@@ -252,41 +372,35 @@ public:
         }
 
     private:
-        Node* ptr_;
+        Link* ptr_;
     };
 
     /*!
         @brief  Constructor for the deque.
                 This constructor sets up the deque to use an allocator.
+                Nothing is allocated until a value is pushed.
 
         @param  allocator
                 The allocator for the deque nodes.
     */
     explicit Deque(Alloc & allocator)
-        : allocator_(&allocator) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        static_assert(sizeof(Node) <= Sizes::alloc_block_size, "Size of Deque<T, Alloc>::Node can be no larger than kty::Sizes::alloc_block_size, due to fixed allocator memory block size.");
-        size_ = 0;
-        head_ = alloc();
-        head_->next = head_;
-        head_->prev = head_;
+        : AllocRef(allocator) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        static_assert(sizeof(Node) <= Alloc::max_block_size, "Size of Deque<T, Alloc>::Node can be no larger than the largest block of Alloc.");
     }
 
     /*!
         @brief  Constructor for the deque.
                 This constructor sets up the deque to use allocating functions.
+                Nothing is allocated until a value is pushed.
 
         @param  getAllocFunc
                 A function that returns a allocator pointer when called.
     */
-    explicit Deque(GetAllocFunc & getAllocFunc = get_alloc) 
-        : getAllocFunc_(&getAllocFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        static_assert(sizeof(Node) <= Sizes::alloc_block_size, "Size of Deque<T, Alloc>::Node can be no larger than kty::Sizes::alloc_block_size, due to fixed allocator memory block size.");
-        size_ = 0;
-        head_ = alloc();
-        head_->next = head_;
-        head_->prev = head_;
+    explicit Deque(GetAllocFunc & getAllocFunc = DefaultGetFunc<GetAllocFunc>::get())
+        : AllocRef(getAllocFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        static_assert(sizeof(Node) <= Alloc::max_block_size, "Size of Deque<T, Alloc>::Node can be no larger than the largest block of Alloc.");
     }
 
     /*!
@@ -295,20 +409,31 @@ public:
         @param  other
                 The deque to copy from.
     */
-    Deque(Deque<value_t, Alloc> const & other) 
-        : allocator_(other.allocator_), getAllocFunc_(other.getAllocFunc_) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        static_assert(sizeof(Node) <= Sizes::alloc_block_size, "Size of Deque<T, Alloc>::Node can be no larger than kty::Sizes::alloc_block_size, due to fixed allocator memory block size.");
-        size_ = 0;
-        head_ = alloc();
-        head_->next = head_;
-        head_->prev = head_;
+    Deque(Deque const & other)
+        : AllocRef(other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Copy over nodes from other deque
         for (ConstIterator it = other.begin(); it != other.end(); ++it) {
             push_back(*it);
         }
     }
 
+    /*!
+        @brief  Move constructor for the deque.
+                Takes over the nodes of the other deque without copying them,
+                unless the other deque holds values in its own blocks, in
+                which case those values are moved over one at a time.
+                The other deque is left empty.
+
+        @param  other
+                The deque to move from.
+    */
+    Deque(Deque && other)
+        : AllocRef(other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        splice_back(other);
+    }
+
     /*!
         @brief  Copy assignment operator for the deque.
 
@@ -317,18 +442,14 @@ public:
 
         @return A reference to this deque after the copy.
     */
-    Deque<value_t, Alloc> & operator=(Deque<value_t, Alloc> const & other) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    Deque & operator=(Deque const & other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&other == this) {
+            return *this;
+        }
         // Clear our own nodes
         clear();
-        dalloc(head_);
-        // Restart our deque
-        allocator_ = other.allocator_;
-        getAllocFunc_ = other.getAllocFunc_;
-        size_ = 0;
-        head_ = alloc();
-        head_->next = head_;
-        head_->prev = head_;
+        AllocRef::operator=(other);
         // Copy over nodes from other deque
         for (ConstIterator it = other.begin(); it != other.end(); ++it) {
             push_back(*it);
@@ -336,54 +457,106 @@ public:
         return *this;
     }
 
+    /*!
+        @brief  Move assignment operator for the deque.
+                Swaps nodes with the other deque, so nothing is copied, and
+                the nodes this deque held are released with the other deque.
+
+        @param  other
+                The deque to move from.
+
+        @return A reference to this deque after the move.
+    */
+    Deque & operator=(Deque && other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        swap(other);
+        return *this;
+    }
+
     /*!
         @brief  Destructor for the deque.
     */
-    virtual ~Deque() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    ~Deque() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         clear();
-        dalloc(head_);
     }
 
     /*!
-        @brief  Performs the correct allocation depending on whether
-                an allocator object is given, or if a function to get
-                an allocator object is given.
-        
+        @brief  Swaps the contents of this deque with another deque.
+                Only the pointers to the nodes are exchanged, along with
+                the allocators they came from. If either deque holds values
+                in its own blocks, the values are moved over instead, and
+                each deque keeps its allocator.
+
+        @param  other
+                The deque to swap with.
+    */
+    void swap(Deque & other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&other == this) {
+            return;
+        }
+        if (!can_relink(other)) {
+            Deque temp(move(other));
+            other.splice_back(*this);
+            splice_back(temp);
+            return;
+        }
+        Link* first = head_.next;
+        Link* last = head_.prev;
+        int count = size_;
+        Link* otherFirst = other.head_.next;
+        Link* otherLast = other.head_.prev;
+        int otherCount = other.size_;
+        reset();
+        other.reset();
+        if (count > 0) {
+            other.link(&other.head_, &other.head_, first, last, count);
+        }
+        if (otherCount > 0) {
+            link(&head_, &head_, otherFirst, otherLast, otherCount);
+        }
+        ::swap(static_cast<AllocRef &>(*this), static_cast<AllocRef &>(other));
+    }
+
+    /*!
+        @brief  Allocates a node from the allocator of this deque.
+                The deque's own blocks are used first, if it has any.
+                Only as many bytes as a node needs are requested, so a
+                slab allocator serves it from its smallest fitting class.
+
         @return A pointer to the allocated node.
     */
     Node * alloc() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (allocator_ != nullptr) {
-            Log.verbose(F("%s: allocator\n"), PRINT_FUNC);
-            return static_cast<Node *>(allocator_->allocate());
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Node * node = static_cast<Node *>(inline_.allocate());
+        if (node != nullptr) {
+            return node;
         }
-        else {
-            Log.verbose(F("%s: getAllocFunc\n"), PRINT_FUNC);
-            return static_cast<Node *>((*getAllocFunc_)(nullptr)->allocate());
+        Alloc * allocator = AllocRef::get();
+        if (allocator == nullptr) {
+            KTY_LOG_WARNING(F("%s: No allocator to allocate from\n"), PRINT_FUNC);
+            return nullptr;
         }
+        return static_cast<Node *>(allocator->allocate(sizeof(Node)));
     }
 
     /*!
-        @brief  Performs the correct deallocation depending on whether
-                an allocator object is given, or if a function to get
-                an allocator object is given.
-        
+        @brief  Deallocates a node to the allocator of this deque.
+                Nodes in the deque's own blocks are given back to it.
+
         @param  ptr
                 The pointer to deallocate.
 
         @return True if the deallocation was successful, false otherwise.
     */
     bool dalloc(Node * ptr) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (allocator_ != nullptr) {
-            Log.verbose(F("%s: allocator\n"), PRINT_FUNC);
-            return allocator_->deallocate(ptr);
-        }
-        else {
-            Log.verbose(F("%s: getAllocFunc\n"), PRINT_FUNC);
-            return (*getAllocFunc_)(nullptr)->deallocate(ptr);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (inline_.owns(ptr)) {
+            return inline_.deallocate(ptr);
         }
+        Alloc * allocator = AllocRef::get();
+        return allocator != nullptr && allocator->deallocate(ptr);
     }
 
     /*!
@@ -391,7 +564,7 @@ public:
 
         @return The number of elements in the deque.
     */
-    virtual int size() const {
+    int size() const {
         return size_;
     }
 
@@ -400,15 +573,15 @@ public:
 
         @return True if the deque is empty, false otherwise.
     */
-    virtual bool is_empty() const {
+    bool is_empty() const {
         return size_ == 0;
     }
 
     /*!
         @brief  Clears all elements in the deque, leaving it empty.
     */
-    virtual void clear() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    void clear() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         while (!is_empty()) {
             pop_front();
         }
@@ -422,23 +595,40 @@ public:
 
         @return True if the push was successful, false otherwise.
     */
-    virtual bool push_front(value_t const & value) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    bool push_front(value_t const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Allocate new node
         Node* toInsert = alloc();
         if (toInsert == nullptr) {
-            Log.warning(F("%s: Unable to push back due to invalid allocated address\n"), PRINT_FUNC);
+            KTY_LOG_WARNING(F("%s: Unable to push back due to invalid allocated address\n"), PRINT_FUNC);
             return false;
         }
         toInsert->value = value;
-        Node* next = head_->next;
-        // Rearrange pointers
-        toInsert->next = next;
-        toInsert->prev = head_;
-        next->prev = toInsert;
-        head_->next = toInsert;
-        ++size_;
-        Log.verbose(F("%s: done\n"), PRINT_FUNC);
+        link(&head_, head_.next, toInsert, toInsert, 1);
+        KTY_LOG_VERBOSE(F("%s: done\n"), PRINT_FUNC);
+        return true;
+    }
+
+    /*!
+        @brief  Pushes a value to the front of the deque.
+                This version moves the value into the deque.
+
+        @param  value
+                The value to push to the front of the deque.
+
+        @return True if the push was successful, false otherwise.
+    */
+    bool push_front(value_t && value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // Allocate new node
+        Node* toInsert = alloc();
+        if (toInsert == nullptr) {
+            KTY_LOG_WARNING(F("%s: Unable to push back due to invalid allocated address\n"), PRINT_FUNC);
+            return false;
+        }
+        toInsert->value = move(value);
+        link(&head_, head_.next, toInsert, toInsert, 1);
+        KTY_LOG_VERBOSE(F("%s: done\n"), PRINT_FUNC);
         return true;
     }
 
@@ -448,21 +638,13 @@ public:
 
         @return True if the push was successful, false otherwise.
     */
-    virtual bool pop_front() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    bool pop_front() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (is_empty()) {
             return false;
         }
-        Node* toRemove = head_->next;
-        Node* next = toRemove->next;
-        // Rearrange pointers to bypass node to be removed
-        head_->next = next;
-        next->prev = head_;
-        // Call destructor before deallocating memory
-        toRemove->value.~value_t();
-        bool result = dalloc(toRemove);
-        --size_;
-        Log.verbose(F("%s: done\n"), PRINT_FUNC);
+        bool result = remove(static_cast<Node *>(head_.next));
+        KTY_LOG_VERBOSE(F("%s: done\n"), PRINT_FUNC);
         return result;
     }
 
@@ -475,23 +657,40 @@ public:
 
         @return True if the push was successful, false otherwise.
     */
-    virtual bool push_back(value_t const & value) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    bool push_back(value_t const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Allocate new node
         Node* toInsert = alloc();
         if (toInsert == nullptr) {
-            Log.warning(F("%s: Unable to push back due to invalid allocated address\n"), PRINT_FUNC);
+            KTY_LOG_WARNING(F("%s: Unable to push back due to invalid allocated address\n"), PRINT_FUNC);
             return false;
         }
         toInsert->value = value_t(value);
-        Node* prev = head_->prev;
-        // Rearrange pointers
-        toInsert->next = head_;
-        toInsert->prev = prev;
-        prev->next = toInsert;
-        head_->prev = toInsert;
-        ++size_;
-        Log.verbose(F("%s: done\n"), PRINT_FUNC);
+        link(head_.prev, &head_, toInsert, toInsert, 1);
+        KTY_LOG_VERBOSE(F("%s: done\n"), PRINT_FUNC);
+        return true;
+    }
+
+    /*!
+        @brief  Pushes a value to the back of the deque.
+                This version moves the value into the deque.
+
+        @param  value
+                The value to push to the back of the deque.
+
+        @return True if the push was successful, false otherwise.
+    */
+    bool push_back(value_t && value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // Allocate new node
+        Node* toInsert = alloc();
+        if (toInsert == nullptr) {
+            KTY_LOG_WARNING(F("%s: Unable to push back due to invalid allocated address\n"), PRINT_FUNC);
+            return false;
+        }
+        toInsert->value = move(value);
+        link(head_.prev, &head_, toInsert, toInsert, 1);
+        KTY_LOG_VERBOSE(F("%s: done\n"), PRINT_FUNC);
         return true;
     }
 
@@ -501,50 +700,39 @@ public:
 
         @return True if the push was successful, false otherwise.
     */
-    virtual bool pop_back() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    bool pop_back() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (is_empty()) {
             return false;
         }
-        Node* toRemove = head_->prev;
-        Node* prev = toRemove->prev;
-        // Rearrange pointers to bypass node to be removed
-        head_->prev = prev;
-        prev->next = head_;
-        // Call destructor before deallocating memory
-        toRemove->value.~value_t();
-        bool result = dalloc(toRemove);
-        --size_;
-        Log.verbose(F("%s: done\n"), PRINT_FUNC);
+        bool result = remove(static_cast<Node *>(head_.prev));
+        KTY_LOG_VERBOSE(F("%s: done\n"), PRINT_FUNC);
         return result;
     }
 
     /*!
         @brief  Returns a reference to the front element of the deque.
                 Has undefined behaviour if the deque is empty.
-                
+
         @return A reference to the element.
     */
-    virtual value_t & front() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    value_t & front() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (size() == 0) {
-            Log.warning(F("%s: size = 0 (undefined behaviour)\n"), PRINT_FUNC);
+            KTY_LOG_WARNING(F("%s: size = 0 (undefined behaviour)\n"), PRINT_FUNC);
+            return empty_value();
         }
-        return head_->next->value;
+        return static_cast<Node *>(head_.next)->value;
     }
 
     /*!
         @brief  Returns a constant reference to the front element of the deque.
                 Has undefined behaviour if the deque is empty.
-                
+
         @return A reference to the element.
     */
-    virtual value_t const & front() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (size() == 0) {
-            Log.warning(F("%s: size = 0 (undefined behaviour)\n"), PRINT_FUNC);
-        }
-        return head_->next->value;
+    value_t const & front() const {
+        return const_cast<Deque *>(this)->front();
     }
 
     /*!
@@ -553,12 +741,13 @@ public:
 
         @return A reference to the element.
     */
-    virtual value_t & back() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    value_t & back() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (size() == 0) {
-            Log.warning(F("%s: size = 0 (undefined behaviour)\n"), PRINT_FUNC);
-        }        
-        return head_->prev->value;
+            KTY_LOG_WARNING(F("%s: size = 0 (undefined behaviour)\n"), PRINT_FUNC);
+            return empty_value();
+        }
+        return static_cast<Node *>(head_.prev)->value;
     }
 
     /*!
@@ -567,12 +756,8 @@ public:
 
         @return A reference to the element.
     */
-    virtual value_t const & back() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (size() == 0) {
-            Log.warning(F("%s: size = 0 (undefined behaviour)\n"), PRINT_FUNC);
-        }        
-        return head_->prev->value;
+    value_t const & back() const {
+        return const_cast<Deque *>(this)->back();
     }
 
     /*!
@@ -580,8 +765,8 @@ public:
 
         @return An iterator to the first element.
     */
-    virtual Iterator begin() {
-        return Iterator(head_->next);
+    Iterator begin() {
+        return Iterator(head_.next);
     }
 
     /*!
@@ -589,8 +774,8 @@ public:
 
         @return A const iterator to the first element.
     */
-    virtual ConstIterator begin() const {
-        return ConstIterator(head_->next);
+    ConstIterator begin() const {
+        return ConstIterator(head_.next);
     }
 
     /*!
@@ -598,148 +783,326 @@ public:
 
         @return A const iterator to the first element.
     */
-    virtual ConstIterator cbegin() const {
-        return ConstIterator(head_->next);
+    ConstIterator cbegin() const {
+        return ConstIterator(head_.next);
     }
 
     /*!
         @brief  Returns an iterator to one past the last element of the deque.
                 Since this is a circular deque, one past the last element is the
-                dummy head node.
+                head link.
 
         @return An iterator to one past the last element.
     */
-    virtual Iterator end() {
-        return Iterator(head_);
+    Iterator end() {
+        return Iterator(&head_);
     }
 
     /*!
         @brief  Returns a const iterator to one past the last element of the deque.
                 Since this is a circular deque, one past the last element is the
-                dummy head node.
+                head link.
 
         @return A const iterator to one past the last element.
     */
-    virtual ConstIterator end() const {
-        return ConstIterator(head_);
+    ConstIterator end() const {
+        return ConstIterator(&head_);
     }
 
     /*!
         @brief  Returns a const iterator to one past the last element of the deque.
                 Since this is a circular deque, one past the last element is the
-                dummy head node.
+                head link.
 
         @return A const iterator to one past the last element.
     */
-    virtual ConstIterator cend() const {
-        return ConstIterator(head_);
+    ConstIterator cend() const {
+        return ConstIterator(&head_);
+    }
+
+    /*!
+        @brief  Moves all elements of another deque to the front of this deque,
+                keeping their order.
+                The nodes are relinked rather than copied, so this takes constant
+                time when both deques allocate from the same place. Otherwise, or
+                if either deque holds values in its own blocks, the elements are
+                moved over one at a time.
+
+        @param  other
+                The deque to take the elements from, which is left empty.
+
+        @return True if the splice was successful, false otherwise.
+    */
+    bool splice_front(Deque & other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&other == this || other.is_empty()) {
+            return true;
+        }
+        if (!can_relink(other)) {
+            while (!other.is_empty()) {
+                if (!push_front(move(other.back()))) {
+                    return false;
+                }
+                other.pop_back();
+            }
+            return true;
+        }
+        Link* first = other.head_.next;
+        Link* last = other.head_.prev;
+        int count = other.size_;
+        other.unlink(first, last, count);
+        link(&head_, head_.next, first, last, count);
+        return true;
+    }
+
+    /*!
+        @brief  Moves all elements of another deque to the back of this deque,
+                keeping their order.
+                The nodes are relinked rather than copied, so this takes constant
+                time when both deques allocate from the same place. Otherwise, or
+                if either deque holds values in its own blocks, the elements are
+                moved over one at a time.
+
+        @param  other
+                The deque to take the elements from, which is left empty.
+
+        @return True if the splice was successful, false otherwise.
+    */
+    bool splice_back(Deque & other) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&other == this || other.is_empty()) {
+            return true;
+        }
+        return append_range(other, other.begin(), other.end());
+    }
+
+    /*!
+        @brief  Moves a range of elements of another deque to the back of this
+                deque, keeping their order.
+                The nodes are relinked rather than copied, so nothing is allocated
+                when both deques allocate from the same place, though the range is
+                walked once to count it. Otherwise, or if either deque holds values
+                in its own blocks, the elements are moved over one at a time.
+
+        @param  other
+                The deque to take the elements from.
+                Must be a different deque from this one.
+
+        @param  first
+                An iterator to the first element of other to take.
+
+        @param  last
+                An iterator to one past the last element of other to take.
+
+        @return True if the append was successful, false otherwise.
+    */
+    bool append_range(Deque & other, Iterator first, Iterator const & last) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&other == this) {
+            KTY_LOG_WARNING(F("%s: cannot append a range of the same deque\n"), PRINT_FUNC);
+            return false;
+        }
+        if (first == last) {
+            return true;
+        }
+        if (!can_relink(other)) {
+            while (first != last) {
+                if (!push_back(move(*first))) {
+                    return false;
+                }
+                first = other.erase(first);
+            }
+            return true;
+        }
+        Link* firstLink = first.ptr_;
+        Link* lastLink = last.ptr_->prev;
+        int count = 1;
+        for (Link* curr = firstLink; curr != lastLink; curr = curr->next) {
+            ++count;
+        }
+        other.unlink(firstLink, lastLink, count);
+        link(head_.prev, &head_, firstLink, lastLink, count);
+        return true;
     }
 
     /*!
         @brief  Erases the node at index.
-        
+
         @param  idx
                 The index of the node to erase.
 
         @return True if the erase was successful, false otherwise.
     */
-    virtual bool erase(int const & idx) {
-        if (idx >= size_) {
-            Log.warning(F("%s: invalid idx %d to erase, size is %d\n"), PRINT_FUNC, idx, size_);
+    bool erase(int const & idx) {
+        if (idx < 0 || idx >= size_) {
+            KTY_LOG_WARNING(F("%s: invalid idx %d to erase, size is %d\n"), PRINT_FUNC, idx, size_);
             return false;
         }
-        Node* toRemove = head_->next;
+        Link* toRemove = head_.next;
         for (int i = 0; i < idx; ++i) {
             toRemove = toRemove->next;
         }
-        Node* prev = toRemove->prev;
-        Node* next = toRemove->next;
-        // Redirect pointers
-        prev->next = next;
-        next->prev = prev;
-        toRemove->value.~value_t();
-        dalloc(toRemove);
-        --size_;
+        remove(static_cast<Node *>(toRemove));
         return true;
     }
 
     /*!
         @brief  Erases the node at the iterator, and returns an iterator to the
                 node after the one which was erased.
-        
+
         @param  it
                 The iterator to the node to erase.
                 This iterator will no longer be valid after this method call.
-        
+
         @return An iterator to the node after the one which was erased.
     */
-    virtual Iterator erase(Iterator const & it) {
-        Node* toRemove = it.ptr_;
-        Node* prev = toRemove->prev;
-        Node* next = toRemove->next;
-        // Redirect pointers
-        prev->next = next;
-        next->prev = prev;
-        toRemove->value.~value_t();
-        dalloc(toRemove);
-        --size_;
+    Iterator erase(Iterator const & it) {
+        Link* next = it.ptr_->next;
+        remove(static_cast<Node *>(it.ptr_));
         return Iterator(next);
     }
 
     /*!
         @brief  Returns a reference to the ith-indexed element of the deque.
-                Has undefined behaviour if the deque has less than i elements. 
+                Has undefined behaviour if the deque has less than i elements.
 
         @param  i
                 The index of the element to retrieve.
 
         @return A reference to the element.
     */
-    virtual value_t & operator[](int const & i) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    value_t & operator[](int const & i) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (i < 0 || i >= size_) {
-            Log.warning(F("%s: accessing index %d when size is %d (undefined behaviour)\n"), PRINT_FUNC, i, i, size_);
+            KTY_LOG_WARNING(F("%s: accessing index %d when size is %d (undefined behaviour)\n"), PRINT_FUNC, i, size_);
+            return empty_value();
         }
-        Node* curr = head_->next;
+        Link* curr = head_.next;
         for (int j = 0; j < i; ++j) {
             curr = curr->next;
         }
-        Log.verbose(F("%s: returning\n"), PRINT_FUNC);
-        return curr->value;
+        KTY_LOG_VERBOSE(F("%s: returning\n"), PRINT_FUNC);
+        return static_cast<Node *>(curr)->value;
     }
 
     /*!
         @brief  Returns a constant reference to the ith-indexed element of the deque.
-                Has undefined behaviour if the deque has less than i elements. 
+                Has undefined behaviour if the deque has less than i elements.
 
         @param  i
                 The index of the element to retrieve.
 
         @return A reference to the element.
     */
-    virtual value_t const & operator[](int const & i) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (i < 0 || i >= size_) {
-            Log.warning(F("%s: accessing index %d when size is %d (undefined behaviour)\n"), PRINT_FUNC, i, i, size_);
-        }
-        Node* curr = head_->next;
-        for (int j = 0; j < i; ++j) {
-            curr = curr->next;
-        }
-        Log.verbose(F("%s: returning\n"), PRINT_FUNC);
-        return curr->value;
+    value_t const & operator[](int const & i) const {
+        return const_cast<Deque *>(this)->operator[](i);
+    }
+
+private:
+    /*!
+        @brief  Checks if nodes can be relinked between another deque and this one.
+                Both must allocate from the same place, and neither may hold
+                values in its own blocks, which cannot leave it.
+
+        @param  other
+                The other deque.
+
+        @return True if the nodes of either deque can be taken by the other,
+                false otherwise.
+    */
+    bool can_relink(Deque const & other) const {
+        return AllocRef::operator==(other)
+            && inline_.num_taken() == 0 && other.inline_.num_taken() == 0;
+    }
+
+    /*!
+        @brief  Links a chain of nodes in between two adjacent links.
+
+        @param  prev
+                The link to come before the chain.
+
+        @param  next
+                The link to come after the chain.
+
+        @param  first
+                The first node of the chain.
+
+        @param  last
+                The last node of the chain.
+
+        @param  count
+                The number of nodes in the chain.
+    */
+    void link(Link* prev, Link* next, Link* first, Link* last, int const & count) {
+        prev->next = first;
+        first->prev = prev;
+        last->next = next;
+        next->prev = last;
+        size_ += count;
+    }
+
+    /*!
+        @brief  Unlinks a chain of nodes from the deque, without releasing them.
+
+        @param  first
+                The first node of the chain.
+
+        @param  last
+                The last node of the chain.
+
+        @param  count
+                The number of nodes in the chain.
+    */
+    void unlink(Link* first, Link* last, int const & count) {
+        first->prev->next = last->next;
+        last->next->prev = first->prev;
+        size_ -= count;
+    }
+
+    /*!
+        @brief  Closes the circle on the head link, leaving the deque empty
+                without releasing any nodes.
+    */
+    void reset() {
+        head_.next = &head_;
+        head_.prev = &head_;
+        size_ = 0;
+    }
+
+    /*!
+        @brief  Unlinks a node from the deque and releases it.
+
+        @param  node
+                The node to remove.
+
+        @return True if the deallocation was successful, false otherwise.
+    */
+    bool remove(Node* node) {
+        unlink(node, node, 1);
+        // Call destructor before deallocating memory
+        node->value.~value_t();
+        return dalloc(node);
+    }
+
+    /*!
+        @brief  Gets a default value to return when a missing element is asked for,
+                so that the undefined behaviour at least stays within valid memory.
+
+        @return A reference to a default value.
+    */
+    static value_t & empty_value() {
+        static value_t value;
+        value = value_t();
+        return value;
     }
 
-protected:
-    /** Pointer to the head node of the internal linked list */
-    Node* head_ = nullptr;
+    /** The head link of the internal linked list, which closes the circle */
+    Link head_ = {&head_, &head_};
     /** Current size of the linked list */
     int size_ = 0;
 
-    /** Pointer to the allocator used to allocate new nodes */
-    Alloc * allocator_ = nullptr;
-    /** Pointer to the function to get the allocator */
-    GetAllocFunc * getAllocFunc_ = nullptr;
+    /** The blocks for the first nodes, stored inside the deque */
+    InlineBlocks<Node, N> inline_;
 
 };
 
@@ -1,17 +1,33 @@
 #pragma once
 
+#include <string.h>
+
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/deque.hpp>
+#include <kty/containers/ring_deque.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/types.hpp>
 
 namespace kty {
 
 /*!
     @brief  Class that mimics having a Deque<Deque<PoolString>>.
+            Holds up to N deques, and up to
+            Sizes::max_num_group_commands strings across all of them.
+            The string pool indices of all the strings are kept in one array,
+            with the strings of each deque next to each other, so that any
+            string of any deque is reached in constant time.
+            Adding a string moves the strings of the deques after it along,
+            which is paid once when a deque is filled, not when it is read.
+            Each string can also be given bytes of compiled code, which are
+            kept in one array in the same order as the strings.
+
+    @tparam N
+            The maximum number of deques.
 */
-template <typename GetAllocFunc = decltype(get_alloc), typename GetPoolFunc = decltype(get_stringpool), typename StringPool = StringPool<Sizes::stringpool_size, Sizes::string_length>>
+template <typename GetAllocFunc = decltype(get_alloc), typename GetPoolFunc = decltype(get_stringpool), typename StringPool = StringPool<Sizes::stringpool_size, Sizes::string_length>, int N = Sizes::max_num_groups>
 class DequeDequePoolString {
 
 public:
@@ -25,21 +41,82 @@ public:
                 A function that returns a pointer to a string pool when called.
     */
     DequeDequePoolString(GetAllocFunc & getAllocFunc = get_alloc, GetPoolFunc & getPoolFunc = get_stringpool) 
-        : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc), strings_(getAllocFunc), sizes_(getAllocFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        codeOffsets_[0] = 0;
     }
 
     /*!
-        @brief  Allocates new space at the front.
+        @brief  Adds a new empty deque at the front.
 
-        @return True if successful, false otherwise.
+        @return True if successful, false if there is no space for another deque.
     */
     bool push_front() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        bool result;
-        result = strings_.push_front(PoolString<StringPool>(*getPoolFunc_));
-        result = sizes_.push_front(0) && result;
-        return result;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (starts_.is_full()) {
+            KTY_LOG_WARNING(F("%s: no space for more than %d deques\n"), PRINT_FUNC, starts_.capacity());
+            return false;
+        }
+        starts_.push_front(numStrings_);
+        sizes_.push_front(0);
+        return true;
+    }
+
+    /*!
+        @brief  Adds a new empty deque at the back,
+                leaving the indices of the other deques unchanged.
+
+        @return True if successful, false if there is no space for another deque.
+    */
+    bool push_back() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (starts_.is_full()) {
+            KTY_LOG_WARNING(F("%s: no space for more than %d deques\n"), PRINT_FUNC, starts_.capacity());
+            return false;
+        }
+        starts_.push_back(numStrings_);
+        sizes_.push_back(0);
+        return true;
+    }
+
+    /*!
+        @brief  Removes the last deque and its strings.
+
+        @return True if successful, false if there are no deques.
+    */
+    bool pop_back() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (starts_.is_empty()) {
+            return false;
+        }
+        clear(size() - 1);
+        starts_.pop_back();
+        sizes_.pop_back();
+        return true;
+    }
+
+    /*!
+        @brief  Moves the strings of the last deque into the ith deque,
+                in place of its own strings, and removes the last deque.
+                The strings and their code are not moved in memory.
+
+        @param  i
+                The deque index, which must not be the last deque.
+
+        @return True if successful, false if i is invalid.
+    */
+    bool replace(int const & i) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (i < 0 || i >= size() - 1) {
+            KTY_LOG_WARNING(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
+            return false;
+        }
+        clear(i);
+        starts_[i] = starts_.back();
+        sizes_[i] = sizes_.back();
+        starts_.pop_back();
+        sizes_.pop_back();
+        return true;
     }
 
     /*!
@@ -48,8 +125,8 @@ public:
         @return The number of deques.
     */
     int size() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        return strings_.size();
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return starts_.size();
     }
 
     /*!
@@ -62,9 +139,9 @@ public:
                 Returns -1 if i is invalid.
     */
     int size(int const & i) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (i < 0 || i >= size()) {
-            Log.warning(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
+            KTY_LOG_WARNING(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
             return -1;
         }
         return sizes_[i];
@@ -76,13 +153,15 @@ public:
         @return True if the clear was successful, false otherwise.
     */
     bool clear() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         bool result = true;
         for (int i = 0; i < size(); ++i) {
             result = clear(i) && result;
         }
-        strings_.clear();
+        starts_.clear();
         sizes_.clear();
+        numStrings_ = 0;
+        codeOffsets_[0] = 0;
         return result;
     }
 
@@ -95,18 +174,35 @@ public:
         @return True if the clear was successful, false otherwise.
     */
     bool clear(int const & i) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (i < 0 || i >= size()) {
-            Log.warning(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
+            KTY_LOG_WARNING(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
             return false;
         }
-        char* stringPoolIndices = strings_[i].c_str();
+        int start = starts_[i];
         int len = sizes_[i];
-        for (int i = 0; i < len; ++i) {
-            int stringPoolIdx = stringPoolIndices[i];
-            (*getPoolFunc_)(nullptr)->deallocate_idx(stringPoolIdx);
+        for (int k = start; k < start + len; ++k) {
+            (*getPoolFunc_)(nullptr)->deallocate_idx(indices_[k]);
+        }
+        // Close the gap left by the strings of the ith deque, and their code
+        int codeStart = codeOffsets_[start];
+        int codeLen = codeOffsets_[start + len] - codeStart;
+        memmove(code_ + codeStart, code_ + codeStart + codeLen, codeOffsets_[numStrings_] - codeStart - codeLen);
+        for (int k = start + len; k < numStrings_; ++k) {
+            indices_[k - len] = indices_[k];
+        }
+        for (int k = start + len; k <= numStrings_; ++k) {
+            codeOffsets_[k - len] = codeOffsets_[k] - codeLen;
+        }
+        numStrings_ -= len;
+        for (int d = 0; d < size(); ++d) {
+            if (starts_[d] >= start + len) {
+                starts_[d] -= len;
+            }
+            else if (starts_[d] > start) {
+                starts_[d] = start;
+            }
         }
-        strings_[i] = "";
         sizes_[i] = 0;
         return true;
     }
@@ -121,23 +217,24 @@ public:
                 The string index within the deque.
         
         @return The string.
-                This string is a copy of the string stored in the deque.
+                This string shares the index of the string stored in the deque,
+                until it is modified.
                 An empty sting is returned if i or j are invalid.
     */
     PoolString<StringPool> get_str(int const & i, int const & j) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         PoolString<StringPool> str(*getPoolFunc_);
         if (i < 0 || i >= size()) {
-            Log.warning(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
+            KTY_LOG_WARNING(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
             return str;
         }
         if (j < 0 || j >= size(i)) {
-            Log.warning(F("%s: accessing index j = %d when size[%d] is %d\n"), PRINT_FUNC, j, i, size(i));            
+            KTY_LOG_WARNING(F("%s: accessing index j = %d when size[%d] is %d\n"), PRINT_FUNC, j, i, size(i));            
             return str;
         }
-        int stringPoolIdx = (int)(strings_[i].c_str()[j]);
-        str = (*getPoolFunc_)(nullptr)->c_str(stringPoolIdx);
-        Log.verbose(F("%s: string returned is %s\n"), PRINT_FUNC, str.c_str());
+        int stringPoolIdx = indices_[starts_[i] + j];
+        str = PoolString<StringPool>(*getPoolFunc_, stringPoolIdx);
+        KTY_LOG_VERBOSE(F("%s: string returned is %s\n"), PRINT_FUNC, str.c_str());
         return str;
     }
 
@@ -154,22 +251,24 @@ public:
                 -1 is returned if i or j are invalid.
     */
     int get_str_idx(int const & i, int const & j) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (i < 0 || i >= size()) {
-            Log.warning(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
+            KTY_LOG_WARNING(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
             return -1;
         }
         if (j < 0 || j >= size(i)) {
-            Log.warning(F("%s: accessing index j = %d when size[%d] is %d\n"), PRINT_FUNC, j, i, size(i));            
+            KTY_LOG_WARNING(F("%s: accessing index j = %d when size[%d] is %d\n"), PRINT_FUNC, j, i, size(i));            
             return -1;
         }
-        int stringPoolIdx = (int)(strings_[i].c_str()[j]);
-        Log.verbose(F("%s: idx is %d\n"), PRINT_FUNC, stringPoolIdx);
+        int stringPoolIdx = indices_[starts_[i] + j];
+        KTY_LOG_VERBOSE(F("%s: idx is %d\n"), PRINT_FUNC, stringPoolIdx);
         return stringPoolIdx;
     }
 
     /*!
-        @brief  Pushes a string to the back of the ith deque
+        @brief  Pushes a string to the back of the ith deque.
+                The string is stored interned, so that identical strings
+                share one index in the string pool.
 
         @param  i
                 The deque index.
@@ -180,27 +279,149 @@ public:
         @return True if successful, false otherwise.
     */
     bool push_back(int const & i, PoolString<StringPool> const & str) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (i < 0 || i >= size()) {
-            Log.warning(F("DequeDequePoolString::push_back accessing index i = %d when size is %d\n"), i, size());
+            KTY_LOG_WARNING(F("DequeDequePoolString::push_back accessing index i = %d when size is %d\n"), i, size());
+            return false;
+        }
+        if (numStrings_ == Sizes::max_num_group_commands) {
+            KTY_LOG_WARNING(F("%s: no space for more than %d strings\n"), PRINT_FUNC, Sizes::max_num_group_commands);
             return false;
         }
-        int stringPoolIdx = (*getPoolFunc_)(nullptr)->allocate_idx();
-        (*getPoolFunc_)(nullptr)->strcpy(stringPoolIdx, str.c_str());
-        char str_[2] = " ";
-        str_[0] = char(stringPoolIdx);
-        strings_[i] += str_;
+        int stringPoolIdx = (*getPoolFunc_)(nullptr)->intern_idx(str.c_str());
+        if (stringPoolIdx == -1) {
+            KTY_LOG_WARNING(F("%s: unable to store %s\n"), PRINT_FUNC, str.c_str());
+            return false;
+        }
+        // Make space after the last string of the ith deque
+        int pos = starts_[i] + sizes_[i];
+        for (int k = numStrings_; k > pos; --k) {
+            indices_[k] = indices_[k - 1];
+        }
+        indices_[pos] = stringPoolIdx;
+        // The new string starts with no code
+        for (int k = numStrings_ + 1; k > pos; --k) {
+            codeOffsets_[k] = codeOffsets_[k - 1];
+        }
+        ++numStrings_;
+        for (int d = 0; d < size(); ++d) {
+            if (d != i && starts_[d] >= pos) {
+                ++starts_[d];
+            }
+        }
         sizes_[i] += 1;
-        Log.verbose(F("%s: %s given stringPoolIdx %d\n"), PRINT_FUNC, str.c_str(), stringPoolIdx);
+        KTY_LOG_VERBOSE(F("%s: %s given stringPoolIdx %d\n"), PRINT_FUNC, str.c_str(), stringPoolIdx);
         return true;
     }
 
+    /*!
+        @brief  Sets the code of the jth string of the ith deque,
+                replacing any code it had.
+
+        @param  i
+                The deque index.
+
+        @param  j
+                The string index within the deque.
+
+        @param  code
+                The bytes of the code.
+
+        @param  len
+                The number of bytes of the code.
+
+        @return True if successful, false if i or j are invalid,
+                or there is no space for the code.
+    */
+    bool set_code(int const & i, int const & j, unsigned char const * code, int const & len) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (i < 0 || i >= size()) {
+            KTY_LOG_WARNING(F("%s: accessing index i = %d when size is %d\n"), PRINT_FUNC, i, size());
+            return false;
+        }
+        if (j < 0 || j >= size(i)) {
+            KTY_LOG_WARNING(F("%s: accessing index j = %d when size[%d] is %d\n"), PRINT_FUNC, j, i, size(i));
+            return false;
+        }
+        int k = starts_[i] + j;
+        int delta = len - (codeOffsets_[k + 1] - codeOffsets_[k]);
+        int codeBytes = codeOffsets_[numStrings_];
+        if (codeBytes + delta > Sizes::group_code_bytes) {
+            KTY_LOG_WARNING(F("%s: no space for more than %d bytes of code\n"), PRINT_FUNC, Sizes::group_code_bytes);
+            return false;
+        }
+        // Move the code of the strings after the jth one to fit the new code
+        memmove(code_ + codeOffsets_[k + 1] + delta, code_ + codeOffsets_[k + 1], codeBytes - codeOffsets_[k + 1]);
+        memcpy(code_ + codeOffsets_[k], code, len);
+        for (int m = k + 1; m <= numStrings_; ++m) {
+            codeOffsets_[m] += delta;
+        }
+        return true;
+    }
+
+    /*!
+        @brief  Gets the number of bytes of code of the jth string of the ith deque.
+
+        @param  i
+                The deque index.
+
+        @param  j
+                The string index within the deque.
+
+        @return The number of bytes of code,
+                which is 0 if the string has no code, or i or j are invalid.
+    */
+    int get_code_size(int const & i, int const & j) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (i < 0 || i >= size() || j < 0 || j >= sizes_[i]) {
+            return 0;
+        }
+        int k = starts_[i] + j;
+        return codeOffsets_[k + 1] - codeOffsets_[k];
+    }
+
+    /*!
+        @brief  Gets the code of the jth string of the ith deque.
+
+        @param  i
+                The deque index.
+
+        @param  j
+                The string index within the deque.
+
+        @return A pointer to the code, which can be changed in place,
+                and stays valid until any deque is changed.
+                nullptr is returned if the string has no code,
+                or i or j are invalid.
+    */
+    unsigned char * get_code(int const & i, int const & j) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (i < 0 || i >= size() || j < 0 || j >= sizes_[i]) {
+            return nullptr;
+        }
+        int k = starts_[i] + j;
+        if (codeOffsets_[k + 1] == codeOffsets_[k]) {
+            return nullptr;
+        }
+        return code_ + codeOffsets_[k];
+    }
+
 private:
     GetAllocFunc * getAllocFunc_ = nullptr;
     GetPoolFunc * getPoolFunc_ = nullptr;
 
-    Deque<PoolString<StringPool>> strings_;
-    Deque<int>          sizes_;
+    /** The string pool indices of the strings of all deques */
+    short indices_[Sizes::max_num_group_commands];
+    /** The number of strings across all deques */
+    int numStrings_ = 0;
+    /** The code of the strings of all deques, in the same order as indices_ */
+    unsigned char code_[Sizes::group_code_bytes];
+    /** Where the code of each string starts in code_, followed by where the code ends */
+    short codeOffsets_[Sizes::max_num_group_commands + 1];
+    /** Where the strings of each deque start in indices_ */
+    RingDeque<int, N> starts_;
+    /** The number of strings in each deque */
+    RingDeque<int, N> sizes_;
     
 };
 
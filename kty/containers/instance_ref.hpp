@@ -0,0 +1,250 @@
+#pragma once
+
+namespace kty {
+
+/*!
+    @brief  Policy that names an allocator or string pool instance at compile time.
+            It can be given to the containers in place of the type of a function
+            that returns the instance, and then the containers reach the instance
+            directly, without storing any pointers or calling through them.
+
+    @tparam T
+            The type of the instance.
+
+    @tparam P
+            The address of the instance, which must have static storage.
+*/
+template <typename T, T * P>
+class StaticInstance {
+
+public:
+    /*!
+        @brief  Gets the instance, like the function it stands in for.
+
+        @return A pointer to the instance.
+    */
+    T * operator()(T * = nullptr) const {
+        return P;
+    }
+
+};
+
+/** Policy naming a string pool at compile time, see StaticInstance. */
+template <typename Pool, Pool * P>
+using StaticPool = StaticInstance<Pool, P>;
+
+/** Policy naming an allocator at compile time, see StaticInstance. */
+template <typename Alloc, Alloc * P>
+using StaticAlloc = StaticInstance<Alloc, P>;
+
+/*!
+    @brief  Gives the function used when a container is not told where its
+            instance is. Specialised next to each function that returns an instance.
+*/
+template <typename GetFunc>
+struct DefaultGetFunc;
+
+/*!
+    @brief  Specialisation of DefaultGetFunc for instances named at compile time.
+*/
+template <typename T, T * P>
+struct DefaultGetFunc<StaticInstance<T, P>> {
+    static StaticInstance<T, P> & get() {
+        static StaticInstance<T, P> policy;
+        return policy;
+    }
+};
+
+/*!
+    @brief  Checks at compile time if two types are the same.
+*/
+template <typename T, typename U>
+struct IsSame {
+    static const bool value = false;
+};
+
+template <typename T>
+struct IsSame<T, T> {
+    static const bool value = true;
+};
+
+/*!
+    @brief  Gives the type R only if a condition is true, so that a template
+            whose return type uses it is left out when the condition is false.
+*/
+template <bool Condition, typename R>
+struct EnableIf {
+};
+
+template <typename R>
+struct EnableIf<true, R> {
+    typedef R type;
+};
+
+/*!
+    @brief  Checks at compile time if a function returns a pointer to a type of instance.
+*/
+template <typename T, typename GetFunc>
+struct ReturnsInstance {
+    static const bool value = IsSame<T *, decltype((*static_cast<GetFunc *>(nullptr))(nullptr))>::value;
+};
+
+/*!
+    @brief  Refers to the allocator or string pool used by a container,
+            either directly, or through a function that returns it when called.
+
+    @tparam T
+            The type of the instance.
+
+    @tparam GetFunc
+            The type of the function that returns the instance.
+*/
+template <typename T, typename GetFunc>
+class InstanceRef {
+
+public:
+    /*!
+        @brief  Constructor for a reference to nothing.
+    */
+    InstanceRef() {
+    }
+
+    /*!
+        @brief  Constructor for a reference to an instance.
+
+        @param  instance
+                The instance.
+    */
+    explicit InstanceRef(T & instance)
+        : instance_(&instance) {
+    }
+
+    /*!
+        @brief  Constructor for a reference through a function.
+                The function must return this type of instance, so that a
+                container of another type is never left without one.
+
+        @param  getFunc
+                A function that returns a pointer to the instance when called.
+    */
+    explicit InstanceRef(GetFunc & getFunc)
+        : getFunc_(&getFunc) {
+        static_assert(ReturnsInstance<T, GetFunc>::value,
+                      "The function does not return this type of instance. "
+                      "Give the container its instance, a function that returns it, or a StaticAlloc or StaticPool policy.");
+    }
+
+    /*!
+        @brief  Gets the instance.
+
+        @return A pointer to the instance, which is null if nothing is referred to.
+    */
+    template <typename F = GetFunc>
+    typename EnableIf<ReturnsInstance<T, F>::value, T *>::type get() const {
+        if (instance_ != nullptr) {
+            return instance_;
+        }
+        else {
+            return getFunc_ == nullptr ? nullptr : (*getFunc_)(nullptr);
+        }
+    }
+
+    /*!
+        @brief  Gets the instance when the function returns a different type
+                of instance, such as the default function for a container of
+                another size. A reference through such a function does not
+                compile, so only an instance given directly is referred to.
+
+        @return A pointer to the instance, which is null if nothing is referred to.
+    */
+    template <typename F = GetFunc>
+    typename EnableIf<!ReturnsInstance<T, F>::value, T *>::type get() const {
+        return instance_;
+    }
+
+    /*!
+        @brief  Checks if this refers to an instance.
+
+        @return True if an instance or function is referred to, false otherwise.
+    */
+    bool is_set() const {
+        return instance_ != nullptr || getFunc_ != nullptr;
+    }
+
+    /*!
+        @brief  Checks if another reference refers to the instance the same way.
+
+        @param  other
+                The other reference.
+
+        @return True if both references are the same, false otherwise.
+    */
+    bool operator==(InstanceRef const & other) const {
+        return instance_ == other.instance_ && getFunc_ == other.getFunc_;
+    }
+
+private:
+    /** A pointer to the instance */
+    T * instance_ = nullptr;
+    /** A pointer to the function to get the instance */
+    GetFunc * getFunc_ = nullptr;
+
+};
+
+/*!
+    @brief  Specialisation of InstanceRef for an instance named at compile time.
+            Stores nothing and always refers to that instance.
+*/
+template <typename T, T * P>
+class InstanceRef<T, StaticInstance<T, P>> {
+
+public:
+    /*!
+        @brief  Constructor for a reference to the instance.
+    */
+    InstanceRef() {
+    }
+
+    /*!
+        @brief  Constructor for a reference to the instance.
+                The given instance is expected to be the one named by P.
+    */
+    explicit InstanceRef(T &) {
+    }
+
+    /*!
+        @brief  Constructor for a reference through the policy.
+    */
+    explicit InstanceRef(StaticInstance<T, P> &) {
+    }
+
+    /*!
+        @brief  Gets the instance.
+
+        @return A pointer to the instance.
+    */
+    T * get() const {
+        return P;
+    }
+
+    /*!
+        @brief  Checks if this refers to an instance, which it always does.
+
+        @return True.
+    */
+    bool is_set() const {
+        return true;
+    }
+
+    /*!
+        @brief  Checks if another reference refers to the same instance, which it always does.
+
+        @return True.
+    */
+    bool operator==(InstanceRef const &) const {
+        return true;
+    }
+
+};
+
+} // namespace kty
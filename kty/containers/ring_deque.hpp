@@ -0,0 +1,523 @@
+#pragma once
+
+#include <kty/log.hpp>
+#include <kty/types.hpp>
+#include <kty/utils.hpp>
+
+namespace kty {
+
+/*!
+    @brief  Double-ended queue with a fixed capacity.
+            Provides quick insertion and deletion at both ends,
+            as well as quick random access.
+            Implemented as a circular buffer of N values stored inside the
+            object, so it never allocates, and pushing onto a full
+            deque fails.
+*/
+template <typename T, int N>
+class RingDeque {
+
+public:
+    /** The type of value stored in the deque */
+    typedef T value_t;
+
+    /*!
+        @brief  The iterator class for the deque.
+    */
+    class Iterator {
+
+    public:
+        /*!
+            @brief  Constructor.
+
+            @param  deque
+                    The deque to iterate over.
+
+            @param  i
+                    The index of the value in the deque.
+        */
+        Iterator(RingDeque * deque, int const & i)
+            : deque_(deque), i_(i) {
+        }
+
+        /*!
+            @brief  Pre-decrement operator.
+
+            @return A reference to the the iterator after decrementing.
+        */
+        Iterator& operator--() {
+            --i_;
+            return *this;
+        }
+
+        /*!
+            @brief  Pre-increment operator.
+
+            @return A reference to the the iterator after incrementing.
+        */
+        Iterator& operator++() {
+            ++i_;
+            return *this;
+        }
+
+        /*!
+            @brief  Dereference operator.
+
+            @return A reference to the value pointed to by the iterator.
+        */
+        value_t & operator*() {
+            return (*deque_)[i_];
+        }
+
+        /*!
+            @brief  Arrow operator.
+
+            @return A pointer to the value pointed to by the iterator.
+        */
+        value_t * operator->() {
+            return &(*deque_)[i_];
+        }
+
+        /*!
+            @brief  Equality comparison operator.
+
+            @param  other
+                    The other iterator to compare to.
+
+            @return True if this and the other iterator point to the same value,
+                    false otherwise.
+        */
+        bool operator==(Iterator const & other) const {
+            return deque_ == other.deque_ && i_ == other.i_;
+        }
+
+        /*!
+            @brief  Non-equality comparison operator.
+
+            @param  other
+                    The other iterator to compare to.
+
+            @return True if this and the other iterator point to different values,
+                    false otherwise.
+        */
+        bool operator!=(Iterator const & other) const {
+            return !operator==(other);
+        }
+
+    private:
+        RingDeque * deque_;
+        int i_;
+    };
+
+    /*!
+        @brief  The constant iterator class for the deque.
+                This behaves similarly to a regular iterator, but
+                the values it points to cannot be changed.
+    */
+    class ConstIterator {
+
+    public:
+        /*!
+            @brief  Constructor.
+
+            @param  deque
+                    The deque to iterate over.
+
+            @param  i
+                    The index of the value in the deque.
+        */
+        ConstIterator(RingDeque const * deque, int const & i)
+            : deque_(deque), i_(i) {
+        }
+
+        /*!
+            @brief  Pre-decrement operator.
+
+            @return A reference to the the iterator after decrementing.
+        */
+        ConstIterator& operator--() {
+            --i_;
+            return *this;
+        }
+
+        /*!
+            @brief  Pre-increment operator.
+
+            @return A reference to the the iterator after incrementing.
+        */
+        ConstIterator& operator++() {
+            ++i_;
+            return *this;
+        }
+
+        /*!
+            @brief  Dereference operator.
+
+            @return A const reference to the value pointed to by the iterator.
+        */
+        value_t const & operator*() const {
+            return (*deque_)[i_];
+        }
+
+        /*!
+            @brief  Arrow operator.
+
+            @return A const pointer to the value pointed to by the iterator.
+        */
+        value_t const * operator->() const {
+            return &(*deque_)[i_];
+        }
+
+        /*!
+            @brief  Equality comparison operator.
+
+            @param  other
+                    The other iterator to compare to.
+
+            @return True if this and the other iterator point to the same value,
+                    false otherwise.
+        */
+        bool operator==(ConstIterator const & other) const {
+            return deque_ == other.deque_ && i_ == other.i_;
+        }
+
+        /*!
+            @brief  Non-equality comparison operator.
+
+            @param  other
+                    The other iterator to compare to.
+
+            @return True if this and the other iterator point to different values,
+                    false otherwise.
+        */
+        bool operator!=(ConstIterator const & other) const {
+            return !operator==(other);
+        }
+
+    private:
+        RingDeque const * deque_;
+        int i_;
+    };
+
+    /*!
+        @brief  Constructor for the deque.
+    */
+    RingDeque() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        static_assert(N > 0, "RingDeque<T, N> must have a capacity of at least 1.");
+    }
+
+    /*!
+        @brief  Returns the size of the deque.
+
+        @return The number of elements in the deque.
+    */
+    int size() const {
+        return size_;
+    }
+
+    /*!
+        @brief  Returns the most elements the deque can hold.
+
+        @return The capacity of the deque.
+    */
+    int capacity() const {
+        return N;
+    }
+
+    /*!
+        @brief  Returns true if the deque is empty, false otherwise.
+
+        @return True if the deque is empty, false otherwise.
+    */
+    bool is_empty() const {
+        return size_ == 0;
+    }
+
+    /*!
+        @brief  Returns true if the deque is full, false otherwise.
+
+        @return True if the deque is full, false otherwise.
+    */
+    bool is_full() const {
+        return size_ == N;
+    }
+
+    /*!
+        @brief  Clears all elements in the deque, leaving it empty.
+    */
+    void clear() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        while (!is_empty()) {
+            pop_back();
+        }
+        head_ = 0;
+    }
+
+    /*!
+        @brief  Pushes a value to the front of the deque.
+
+        @param  value
+                The value to push to the front of the deque.
+
+        @return True if the push was successful, false if the deque is full.
+    */
+    bool push_front(value_t const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (is_full()) {
+            KTY_LOG_WARNING(F("%s: Unable to push front, deque is full at %d\n"), PRINT_FUNC, N);
+            return false;
+        }
+        head_ = head_ == 0 ? N - 1 : head_ - 1;
+        ++size_;
+        values_[head_] = value;
+        return true;
+    }
+
+    /*!
+        @brief  Pushes a value to the front of the deque.
+                This version moves the value into the deque.
+
+        @param  value
+                The value to push to the front of the deque.
+
+        @return True if the push was successful, false if the deque is full.
+    */
+    bool push_front(value_t && value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (is_full()) {
+            KTY_LOG_WARNING(F("%s: Unable to push front, deque is full at %d\n"), PRINT_FUNC, N);
+            return false;
+        }
+        head_ = head_ == 0 ? N - 1 : head_ - 1;
+        ++size_;
+        values_[head_] = move(value);
+        return true;
+    }
+
+    /*!
+        @brief  Pops value from the front of the deque.
+                The slot is reset to a default value, so that anything the
+                value holds on to is released straight away.
+
+        @return True if the pop was successful, false if the deque is empty.
+    */
+    bool pop_front() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (is_empty()) {
+            return false;
+        }
+        values_[head_] = value_t();
+        head_ = head_ == N - 1 ? 0 : head_ + 1;
+        --size_;
+        return true;
+    }
+
+    /*!
+        @brief  Pushes a value to the back of the deque.
+
+        @param  value
+                The value to push to the back of the deque.
+
+        @return True if the push was successful, false if the deque is full.
+    */
+    bool push_back(value_t const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (is_full()) {
+            KTY_LOG_WARNING(F("%s: Unable to push back, deque is full at %d\n"), PRINT_FUNC, N);
+            return false;
+        }
+        ++size_;
+        values_[slot(size_ - 1)] = value;
+        return true;
+    }
+
+    /*!
+        @brief  Pushes a value to the back of the deque.
+                This version moves the value into the deque.
+
+        @param  value
+                The value to push to the back of the deque.
+
+        @return True if the push was successful, false if the deque is full.
+    */
+    bool push_back(value_t && value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (is_full()) {
+            KTY_LOG_WARNING(F("%s: Unable to push back, deque is full at %d\n"), PRINT_FUNC, N);
+            return false;
+        }
+        ++size_;
+        values_[slot(size_ - 1)] = move(value);
+        return true;
+    }
+
+    /*!
+        @brief  Pops value from the back of the deque.
+                The slot is reset to a default value, so that anything the
+                value holds on to is released straight away.
+
+        @return True if the pop was successful, false if the deque is empty.
+    */
+    bool pop_back() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (is_empty()) {
+            return false;
+        }
+        values_[slot(size_ - 1)] = value_t();
+        --size_;
+        return true;
+    }
+
+    /*!
+        @brief  Returns a reference to the front element of the deque.
+                Has undefined behaviour if the deque is empty.
+
+        @return A reference to the element.
+    */
+    value_t & front() {
+        return operator[](0);
+    }
+
+    /*!
+        @brief  Returns a constant reference to the front element of the deque.
+                Has undefined behaviour if the deque is empty.
+
+        @return A reference to the element.
+    */
+    value_t const & front() const {
+        return operator[](0);
+    }
+
+    /*!
+        @brief  Returns a reference to the back element of the deque.
+                Has undefined behaviour if the deque is empty.
+
+        @return A reference to the element.
+    */
+    value_t & back() {
+        return operator[](size_ - 1);
+    }
+
+    /*!
+        @brief  Returns a constant reference to the back element of the deque.
+                Has undefined behaviour if the deque is empty.
+
+        @return A reference to the element.
+    */
+    value_t const & back() const {
+        return operator[](size_ - 1);
+    }
+
+    /*!
+        @brief  Returns an iterator to the first element of the deque.
+
+        @return An iterator to the first element.
+    */
+    Iterator begin() {
+        return Iterator(this, 0);
+    }
+
+    /*!
+        @brief  Returns a const iterator to the first element of the deque.
+
+        @return A const iterator to the first element.
+    */
+    ConstIterator begin() const {
+        return ConstIterator(this, 0);
+    }
+
+    /*!
+        @brief  Returns a const iterator to the first element of the deque.
+
+        @return A const iterator to the first element.
+    */
+    ConstIterator cbegin() const {
+        return ConstIterator(this, 0);
+    }
+
+    /*!
+        @brief  Returns an iterator to one past the last element of the deque.
+
+        @return An iterator to one past the last element.
+    */
+    Iterator end() {
+        return Iterator(this, size_);
+    }
+
+    /*!
+        @brief  Returns a const iterator to one past the last element of the deque.
+
+        @return A const iterator to one past the last element.
+    */
+    ConstIterator end() const {
+        return ConstIterator(this, size_);
+    }
+
+    /*!
+        @brief  Returns a const iterator to one past the last element of the deque.
+
+        @return A const iterator to one past the last element.
+    */
+    ConstIterator cend() const {
+        return ConstIterator(this, size_);
+    }
+
+    /*!
+        @brief  Returns a reference to the ith-indexed element of the deque.
+                Has undefined behaviour if the deque has less than i elements,
+                though the reference always stays within the buffer.
+
+        @param  i
+                The index of the element to retrieve.
+
+        @return A reference to the element.
+    */
+    value_t & operator[](int const & i) {
+        if (i < 0 || i >= size_) {
+            KTY_LOG_WARNING(F("%s: accessing index %d when size is %d (undefined behaviour)\n"), PRINT_FUNC, i, size_);
+        }
+        return values_[slot(i)];
+    }
+
+    /*!
+        @brief  Returns a constant reference to the ith-indexed element of the deque.
+                Has undefined behaviour if the deque has less than i elements,
+                though the reference always stays within the buffer.
+
+        @param  i
+                The index of the element to retrieve.
+
+        @return A reference to the element.
+    */
+    value_t const & operator[](int const & i) const {
+        if (i < 0 || i >= size_) {
+            KTY_LOG_WARNING(F("%s: accessing index %d when size is %d (undefined behaviour)\n"), PRINT_FUNC, i, size_);
+        }
+        return values_[slot(i)];
+    }
+
+private:
+    /*!
+        @brief  Gets the buffer slot of the ith-indexed element.
+
+        @param  i
+                The index of the element.
+
+        @return The buffer slot, wrapped around the end of the buffer.
+    */
+    int slot(int const & i) const {
+        int s = (head_ + i) % N;
+        return s < 0 ? s + N : s;
+    }
+
+    /** The buffer the values are stored in */
+    value_t values_[N];
+    /** The buffer slot of the first value */
+    int head_ = 0;
+    /** Current size of the deque */
+    int size_ = 0;
+
+};
+
+} // namespace kty
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <kty/containers/deque.hpp>
+#include <kty/containers/instance_ref.hpp>
+#include <kty/containers/string_view.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/sizes.hpp>
 #include <kty/types.hpp>
 
@@ -11,9 +14,18 @@ namespace kty {
     @brief  Thin wrapper class around a poolstring_t that redirects
             API calls to the string pool, as well as introducing some
             API shortcuts.
+            Strings of up to Sizes::small_string_length characters are
+            stored inside the object instead, and only take an index from
+            the pool once they grow longer.
+            The pool is either given directly, reached through a function,
+            or named at compile time with a StaticPool policy as GetPoolFunc,
+            in which case the string holds nothing but its index or characters.
 */
 template <class Pool = StringPool<Sizes::stringpool_size, Sizes::string_length>, class GetPoolFunc = decltype(get_stringpool)>
-class PoolString {
+class PoolString : private InstanceRef<Pool, GetPoolFunc> {
+
+    /** The type referring to the pool for this string */
+    typedef InstanceRef<Pool, GetPoolFunc> PoolRef;
 
 public:
     /*!
@@ -25,19 +37,12 @@ public:
 
         @param  idx
                 An already allocated index in the pool for this string.
-                If not provided, a new one will be allocated from the pool.
+                If not provided, the string starts empty, without an index.
     */
     PoolString(Pool & pool, int const & idx = -1) 
-        : pool_(&pool) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (idx == -1) {
-            poolIdx_ = alloc();
-            operator=("");
-        }
-        else {
-            poolIdx_ = idx;
-            pool_->inc_ref_count(poolIdx_);
-        }
+        : PoolRef(pool) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        take_idx(idx);
     }
 
     /*!
@@ -51,12 +56,11 @@ public:
                 The initial string to store.
     */
     PoolString(Pool & pool, char const * str) 
-        : pool_(&pool) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (::strlen(str) > pool_->max_str_len()) {
-            Log.warning(F("%s: length of str %d is above maximum of %d, will be truncated\n"), PRINT_FUNC, ::strlen(str), pool_->max_str_len());
+        : PoolRef(pool) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (::strlen(str) > get_pool()->max_str_len()) {
+            KTY_LOG_WARNING(F("%s: length of str %d is above maximum of %d, will be truncated\n"), PRINT_FUNC, ::strlen(str), get_pool()->max_str_len());
         }
-        poolIdx_ = alloc();
         operator=(str);
     }
 
@@ -64,10 +68,8 @@ public:
         @brief  Constructor for a pool string.
     */
     PoolString() 
-        : getPoolFunc_(&get_stringpool) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        poolIdx_ = alloc();
-        operator=("");
+        : PoolRef(DefaultGetFunc<GetPoolFunc>::get()) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     }
 
     /*!
@@ -78,19 +80,12 @@ public:
 
         @param  idx
                 An already allocated index in the pool for this string.
-                If not provided, a new one will be allocated from the pool.
+                If not provided, the string starts empty, without an index.
     */
     PoolString(GetPoolFunc & getPoolFunc, int const & idx = -1) 
-        : getPoolFunc_(&getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (idx == -1) {
-            poolIdx_ = alloc();
-            operator=("");
-        }
-        else {
-            poolIdx_ = idx;
-            (*getPoolFunc_)(nullptr)->inc_ref_count(poolIdx_);
-        }
+        : PoolRef(getPoolFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        take_idx(idx);
     }
 
     /*!
@@ -98,22 +93,15 @@ public:
 
         @param  idx
                 An already allocated index in the pool for this string.
-                If not provided, a new one will be allocated from the pool.
+                If not provided, the string starts empty, without an index.
 
         @param  getPoolFunc
                 A function that returns a pointer to a string pool when called.
     */
-    PoolString(int const & idx, GetPoolFunc & getPoolFunc = get_stringpool) 
-        : getPoolFunc_(&getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (idx == -1) {
-            poolIdx_ = alloc();
-            operator=("");
-        }
-        else {
-            poolIdx_ = idx;
-            (*getPoolFunc_)(nullptr)->inc_ref_count(poolIdx_);
-        }
+    PoolString(int const & idx, GetPoolFunc & getPoolFunc = DefaultGetFunc<GetPoolFunc>::get()) 
+        : PoolRef(getPoolFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        take_idx(idx);
     }
 
     /*!
@@ -127,12 +115,11 @@ public:
                 The initial string to store.
     */
     PoolString(GetPoolFunc & getPoolFunc, char const * str) 
-        : getPoolFunc_(&getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (::strlen(str) > pool_->max_str_len()) {
-            Log.warning(F("%s: length of str %d is above maximum of %d, will be truncated\n"), PRINT_FUNC, ::strlen(str), pool_->max_str_len());
+        : PoolRef(getPoolFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (::strlen(str) > get_pool()->max_str_len()) {
+            KTY_LOG_WARNING(F("%s: length of str %d is above maximum of %d, will be truncated\n"), PRINT_FUNC, ::strlen(str), get_pool()->max_str_len());
         }
-        poolIdx_ = alloc();
         operator=(str);
     }
 
@@ -146,29 +133,43 @@ public:
                 A function that returns a pointer to a string pool
                 when called.
     */
-    PoolString(char const * str, GetPoolFunc & getPoolFunc = get_stringpool) 
-        : getPoolFunc_(&getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (::strlen(str) > pool_->max_str_len()) {
-            Log.warning(F("%s: length of str %d is above maximum of %d, will be truncated\n"), PRINT_FUNC, ::strlen(str), pool_->max_str_len());
+    PoolString(char const * str, GetPoolFunc & getPoolFunc = DefaultGetFunc<GetPoolFunc>::get()) 
+        : PoolRef(getPoolFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (::strlen(str) > get_pool()->max_str_len()) {
+            KTY_LOG_WARNING(F("%s: length of str %d is above maximum of %d, will be truncated\n"), PRINT_FUNC, ::strlen(str), get_pool()->max_str_len());
         }
-        poolIdx_ = alloc();
         operator=(str);
     }
 
     /*!
         @brief  Copy constructor for a pool string.
-                Only copies the contents of the string and the pool used, 
-                such that both this and the other string are pointing to 
-                different memory locations.
+                Both strings share the index of the other string,
+                until one of them is modified.
 
         @param  str
                 A reference to the other pool string to copy contents from.
     */
-    PoolString(PoolString const & str) {
+    PoolString(PoolString const & str)
+        : PoolRef(str) {
         operator=(str);
     }
 
+    /*!
+        @brief  Move constructor for a pool string.
+                Takes over the index of the other string, without touching
+                its reference count.
+                The other string is left empty.
+
+        @param  str
+                The other pool string to move from.
+    */
+    PoolString(PoolString && str)
+        : PoolRef(str), pooled_(str.pooled_), interned_(str.interned_) {
+        ::memcpy(chars_, str.chars_, sizeof(chars_));
+        str.clear();
+    }
+
     /*!
         @brief  Copies another string to this string.
 
@@ -179,20 +180,44 @@ public:
                 has been performed.
     */
     PoolString& operator=(char const * str) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (pool_ != nullptr) {
-            Log.verbose(F("%s: pool\n"), PRINT_FUNC);
-            pool_->strcpy(poolIdx_, str);
-        }
-        else {
-            Log.verbose(F("%s: getPoolFunc\n"), PRINT_FUNC);
-            (*getPoolFunc_)(nullptr)->strcpy(poolIdx_, str);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return operator=(StringView(str));
+    }
+
+    /*!
+        @brief  Assignment operator from a string view.
+                Only the characters of the view are copied, so it does not
+                need to be null terminated.
+
+        @param  str
+                The string view to copy the characters of.
+
+        @return A reference to this string.
+    */
+    PoolString& operator=(StringView const & str) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int len = str.strlen();
+        if (len <= smallLength_) {
+            // str may point into this string, so copy it before letting go of the index
+            int idx = pooled_ ? poolIdx_ : -1;
+            ::memmove(chars_, str.data(), len);
+            chars_[len] = '\0';
+            pooled_ = false;
+            interned_ = false;
+            if (idx >= 0) {
+                dalloc(idx);
+            }
+            return *this;
         }
+        make_unique(false);
+        get_pool()->strncpy(poolIdx_, str.data(), len);
         return *this;
     }
 
     /*!
-        @brief  Copy assignment operator
+        @brief  Copy assignment operator.
+                The characters of a long string are not copied, both strings
+                share the index of the other string until one of them is modified.
 
         @param  str
                 The other pool string to copy from.
@@ -201,19 +226,45 @@ public:
                 has been performed.
     */
     PoolString& operator=(PoolString const & str) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (pool_ != nullptr && pool_->owns(poolIdx_)) {
-            Log.verbose(F("%s: properly initialised pool string\n"), PRINT_FUNC);
-            pool_->deallocate_idx(poolIdx_);
-        }
-        else if (getPoolFunc_ != nullptr && (*getPoolFunc_)(nullptr)->owns(poolIdx_)) {
-            Log.verbose(F("%s: properly initialised getPoolFunc string\n"), PRINT_FUNC);
-            (*getPoolFunc_)(nullptr)->deallocate_idx(poolIdx_);
-        }
-        pool_ = str.pool_;
-        getPoolFunc_ = str.getPoolFunc_;
-        poolIdx_ = alloc();
-        operator=(str.c_str());
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&str == this) {
+            return *this;
+        }
+        // Take the new reference first, in case both strings already share an index
+        if (str.pooled_) {
+            str.get_pool()->inc_ref_count(str.poolIdx_);
+        }
+        release();
+        PoolRef::operator=(str);
+        ::memcpy(chars_, str.chars_, sizeof(chars_));
+        pooled_ = str.pooled_;
+        interned_ = str.interned_;
+        return *this;
+    }
+
+    /*!
+        @brief  Move assignment operator.
+                Takes over the index of the other string, without touching
+                its reference count.
+                The other string is left empty.
+
+        @param  str
+                The other pool string to move from.
+
+        @return A reference to this string, after the move
+                has been performed.
+    */
+    PoolString& operator=(PoolString && str) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (&str == this) {
+            return *this;
+        }
+        release();
+        PoolRef::operator=(str);
+        ::memcpy(chars_, str.chars_, sizeof(chars_));
+        pooled_ = str.pooled_;
+        interned_ = str.interned_;
+        str.clear();
         return *this;
     }
 
@@ -221,42 +272,23 @@ public:
         @brief  Destructor for a pool string.
     */
     ~PoolString() {
-        if (poolIdx_ >= 0) {
+        if (pooled_ && poolIdx_ >= 0) {
             dalloc(poolIdx_);
         }
-        /*if (pool_ != nullptr && pool_->owns(poolIdx_)) {
-            Log.verbose(F("%s: returning %d: \"%s\" using pool\n"), PRINT_FUNC, poolIdx_, c_str());
-            pool_->deallocate_idx(poolIdx_);
-        }
-        else if (getPoolFunc_ != nullptr && (*getPoolFunc_)(nullptr)->owns(poolIdx_)) {
-            Log.verbose(F("%s: returning %d: \"%s\" using getPoolFunc\n"), PRINT_FUNC, poolIdx_, c_str());
-            (*getPoolFunc_)(nullptr)->deallocate_idx(poolIdx_);
-        }*/
     }
 
     /*!
-        @brief  Performs the correct allocation depending on whether
-                a string pool object is given, or if a function to get
-                a string pool object is given.
+        @brief  Allocates an index from the pool of this string.
 
         @return The allocated index.
     */
     int alloc() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (pool_ != nullptr) {
-            Log.verbose(F("%s: pool\n"), PRINT_FUNC);
-            return pool_->allocate_idx();
-        }
-        else {
-            Log.verbose(F("%s: getPoolFunc\n"), PRINT_FUNC);
-            return (*getPoolFunc_)(nullptr)->allocate_idx();
-        }
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return get_pool()->allocate_idx();
     }
 
     /*!
-        @brief  Performs the correct deallocation depending on whether
-                a string pool object is given, or if a function to get
-                a string pool object is given.
+        @brief  Deallocates an index from the pool of this string.
 
         @param  idx
                 The index to deallocate.
@@ -264,39 +296,67 @@ public:
         @return True if the deallocation was successful, false otherwise.
     */
     bool dalloc(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (pool_ != nullptr) {
-            Log.verbose(F("%s: pool\n"), PRINT_FUNC);
-            return pool_->deallocate_idx(idx);
-        }
-        else {
-            Log.verbose(F("%s: getPoolFunc\n"), PRINT_FUNC);
-            return (*getPoolFunc_)(nullptr)->deallocate_idx(idx);
-        }
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return get_pool()->deallocate_idx(idx);
     }
 
     /*!
         @brief  Get the pool index of this string.
 
-        @return The pool index of this string.
+        @return The pool index of this string,
+                or -1 if it is short enough to be stored inside the string.
     */
     int pool_idx() const {
-        return poolIdx_;
+        return pooled_ ? poolIdx_ : -1;
+    }
+
+    /*!
+        @brief  Moves this string to an interned index, which is shared
+                with every other interned string holding the same characters.
+                Interned strings are copied and compared by index.
+                Modifying an interned string first gives it its own index again.
+                Strings stored inside the object are cheap to copy and compare
+                already, so they are left as they are.
+
+        @return A reference to this string.
+    */
+    PoolString & intern() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!interned_ && pooled_) {
+            int idx = get_pool()->intern_idx(c_str());
+            if (idx == -1) {
+                return *this;
+            }
+            dalloc(poolIdx_);
+            poolIdx_ = idx;
+            interned_ = get_pool()->is_interned(poolIdx_);
+        }
+        return *this;
+    }
+
+    /*!
+        @brief  Checks if this string is interned.
+
+        @return True if this string is interned, false otherwise.
+    */
+    bool is_interned() const {
+        return interned_;
     }
 
     /*!
         @brief  Returns a string which is in "c-style". 
                 This form is suitable for passing to Arduino serial print.
-        
+                A short string is stored inside the object, so the pointer is
+                only valid while this object lives and is not modified. Bind a
+                temporary string to a local before taking its c_str().
+
         @return A pointer to the first character in the string.
     */
     char* c_str() const {
-        if (pool_ != nullptr) {
-            return pool_->c_str(poolIdx_);
-        }
-        else {
-            return (*getPoolFunc_)(nullptr)->c_str(poolIdx_);
+        if (!pooled_) {
+            return const_cast<char *>(chars_);
         }
+        return get_pool()->c_str(poolIdx_);
     }
 
     /*!
@@ -306,12 +366,7 @@ public:
                 The string to copy from.
     */
     void strcpy(char const * str) {
-        if (pool_ != nullptr) {
-            pool_->strcpy(poolIdx_, str);
-        }
-        else {
-            (*getPoolFunc_)(nullptr)->strcpy(poolIdx_, str);
-        }
+        operator=(str);
     }
 
     /*!
@@ -321,12 +376,28 @@ public:
                 The string to concatenate onto this string.
     */
     void strcat(char const * str) {
-        if (pool_ != nullptr) {
-            pool_->strcat(poolIdx_, str);
-        }
-        else {
-            (*getPoolFunc_)(nullptr)->strcat(poolIdx_, str);
+        if (!pooled_) {
+            int len = ::strlen(chars_);
+            int catLen = ::strlen(str);
+            if (len + catLen <= smallLength_) {
+                ::memmove(chars_ + len, str, catLen + 1);
+                return;
+            }
+            // Too long to keep inside, move the characters to the pool.
+            // str may point into this string, so it is appended before
+            // the index overwrites the characters.
+            int idx = alloc();
+            if (idx == -1) {
+                return;
+            }
+            get_pool()->strcpy(idx, chars_);
+            get_pool()->strcat(idx, str);
+            pooled_ = true;
+            poolIdx_ = idx;
+            return;
         }
+        make_unique();
+        get_pool()->strcat(poolIdx_, str);
     }
 
     /*!
@@ -345,11 +416,15 @@ public:
 
     /*!
         @brief  Gets the length of the string.
+                The length is kept by the pool, so this takes constant time.
 
         @return The length of the string, in number of characters.
     */
     int strlen() const {
-        return ::strlen(c_str());
+        if (!pooled_) {
+            return ::strlen(chars_);
+        }
+        return get_pool()->strlen(poolIdx_);
     }
 
     /*!
@@ -365,7 +440,8 @@ public:
     }
 
     /*!
-        @brief  Compares another pool string to this string for equality
+        @brief  Compares another pool string to this string for equality.
+                Two interned strings are compared by where they are stored.
 
         @param  str
                 The string to compare to.
@@ -373,6 +449,9 @@ public:
         @return True if the two strings are the same, false otherwise.
     */
     bool operator==(PoolString const & str) const {
+        if (interned_ && str.interned_) {
+            return c_str() == str.c_str();
+        }
         return strcmp(str.c_str()) == 0;
     }
 
@@ -443,8 +522,12 @@ public:
         
         @return A reference to the character stored at that index.
                 This method has undefined behaviour if i is out of bounds.
+                Since the character may be written to, the stored length of
+                the string is found again the next time it is needed.
     */
     char& operator[](int const & i) {
+        make_unique();
+        invalidate_len();
         return c_str()[i];
     }
 
@@ -555,12 +638,14 @@ public:
                 The index to insert the string into.
     */
     void insert(char const * str, int const & idx = 0) {
-        char buffer[pool_->max_str_len() + 1];
-        memset(static_cast<void *>(const_cast<char *>(buffer)), '\0', pool_->max_str_len() + 1);
+        make_unique();
+        char buffer[get_pool()->max_str_len() + 1];
+        memset(static_cast<void *>(const_cast<char *>(buffer)), '\0', get_pool()->max_str_len() + 1);
         // Copy all characters from the insert idx to the temporary buffer
         ::strcpy(buffer, c_str() + idx);
         // Insert characters
         c_str()[idx] = '\0';
+        invalidate_len();
         operator+=(str);
         // Put back characters after inserted string
         operator+=(buffer);
@@ -583,7 +668,7 @@ public:
         if (length == -1) {
             length = strlen();
         }
-        int maxStrLen = pool_->max_str_len();
+        int maxStrLen = get_pool()->max_str_len();
         char buffer[maxStrLen + 1];
         memset(static_cast<void *>(const_cast<char *>(buffer)), '\0', maxStrLen + 1);
         int lenToCopy = length < maxStrLen ? length : maxStrLen;
@@ -610,22 +695,141 @@ public:
         if (end == -1) {
             end = strlen();
         }
-        PoolString substring;
-        char str_[2] = " ";
-        for (int i = begin; i < end; ++i) {
-            str_[0] = c_str()[i];
-            substring += str_;
-        }
+        PoolString substring(static_cast<PoolRef const &>(*this));
+        substring = StringView(c_str() + begin, end > begin ? end - begin : 0);
         return substring;
     }
 
 private:
-    /** The pool index for this string. */
-    int poolIdx_ = -1;
-    /** A pointer to the pool for this string. */
-    Pool * pool_ = nullptr;
-    /** A pointer to a function that returns a pointer to a pool. */
-    GetPoolFunc * getPoolFunc_ = nullptr;
+    /*!
+        @brief  Constructor for an empty string using the same pool as another.
+
+        @param  poolRef
+                The reference to the pool of the other string.
+    */
+    explicit PoolString(PoolRef const & poolRef)
+        : PoolRef(poolRef) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+    }
+
+    /*!
+        @brief  Gets the pool for this string.
+
+        @return A pointer to the pool.
+    */
+    Pool * get_pool() const {
+        return PoolRef::get();
+    }
+
+    /*!
+        @brief  Takes a reference to an already allocated index.
+
+        @param  idx
+                The index, or -1 to leave the string empty.
+    */
+    void take_idx(int const & idx) {
+        if (idx != -1) {
+            pooled_ = true;
+            poolIdx_ = idx;
+            get_pool()->inc_ref_count(poolIdx_);
+            interned_ = get_pool()->is_interned(poolIdx_);
+        }
+    }
+
+    /*!
+        @brief  Leaves this string empty, stored inside the object.
+                Any index it had must already have been given up or taken over.
+    */
+    void clear() {
+        pooled_ = false;
+        interned_ = false;
+        chars_[0] = '\0';
+    }
+
+    /*!
+        @brief  Gives up this string's reference to its index, if it has
+                a valid one.
+    */
+    void release() {
+        if (!pooled_) {
+            return;
+        }
+        Pool * pool = get_pool();
+        if (pool != nullptr && pool->owns(poolIdx_)) {
+            KTY_LOG_VERBOSE(F("%s: properly initialised pool string\n"), PRINT_FUNC);
+            pool->deallocate_idx(poolIdx_);
+        }
+    }
+
+    /*!
+        @brief  Gets the number of strings sharing the index of this string.
+
+        @return The reference count of the index.
+    */
+    int ref_count() const {
+        return get_pool()->ref_count(poolIdx_);
+    }
+
+    /*!
+        @brief  Tells the pool that the characters of this string were
+                written to directly, so its stored length may be wrong.
+    */
+    void invalidate_len() {
+        if (!pooled_) {
+            return;
+        }
+        get_pool()->invalidate_len(poolIdx_);
+    }
+
+    /*!
+        @brief  Gives this string its own index before it is modified,
+                if its index is shared with other strings, either because
+                it is interned or because this string is a copy.
+                A string stored inside the object is always unique, and is
+                only given an index if its characters are about to be
+                overwritten by a string too long to stay inside.
+                A string whose index could not be allocated tries again.
+
+        @param  keepChars
+                True to copy the characters to the new index, false if
+                they are about to be overwritten anyway.
+    */
+    void make_unique(bool const & keepChars = true) {
+        if (!pooled_ && keepChars) {
+            return;
+        }
+        if (!pooled_) {
+            pooled_ = true;
+            interned_ = false;
+            poolIdx_ = alloc();
+        }
+        if (poolIdx_ == -1) {
+            poolIdx_ = alloc();
+        }
+        else if (interned_ || ref_count() > 1) {
+            int idx = alloc();
+            if (keepChars) {
+                get_pool()->strcpy(idx, c_str());
+            }
+            dalloc(poolIdx_);
+            poolIdx_ = idx;
+            interned_ = false;
+        }
+    }
+
+    /** The longest string that is stored inside the object. */
+    static const int smallLength_ = Sizes::small_string_length;
+    union {
+        /** The pool index for this string, when it is stored in the pool. */
+        short poolIdx_;
+        /** The characters of this string, when it is stored inside the object. */
+        char chars_[smallLength_ + 1] = "";
+    };
+    /** Whether the string is stored in the pool instead of inside the object.
+        A zero filled string is then an empty string stored inside. */
+    bool pooled_ = false;
+    /** Whether the pool index is interned, and so shared with other strings. */
+    bool interned_ = false;
 
 };
 
@@ -0,0 +1,174 @@
+#pragma once
+
+namespace kty {
+
+/*!
+    @brief  Class that refers to a run of characters stored elsewhere,
+            by a pointer and a length.
+            The characters are not copied and are not null terminated,
+            so a view is only valid for as long as the string it refers
+            to is not modified, moved or destroyed.
+*/
+class StringView {
+
+public:
+
+    /*!
+        @brief  Constructor for an empty string view.
+    */
+    StringView() {
+    }
+
+    /*!
+        @brief  Constructor for a string view of some characters.
+
+        @param  str
+                The first character of the view.
+
+        @param  len
+                The number of characters in the view.
+    */
+    StringView(char const * str, int const & len)
+        : str_(str), len_(len) {
+    }
+
+    /*!
+        @brief  Constructor for a string view of a whole null terminated string.
+
+        @param  str
+                The string.
+    */
+    StringView(char const * str)
+        : str_(str), len_(::strlen(str)) {
+    }
+
+    /*!
+        @brief  Constructor for a string view of a whole pool string.
+                The view does not hold a reference to the string's index.
+
+        @param  str
+                The pool string.
+    */
+    template <typename PoolString>
+    StringView(PoolString const & str)
+        : str_(str.c_str()), len_(str.strlen()) {
+    }
+
+    /*!
+        @brief  Gets the characters of the view.
+
+        @return A pointer to the first character of the view.
+                The characters are not null terminated.
+    */
+    char const * data() const {
+        return str_;
+    }
+
+    /*!
+        @brief  Gets the length of the view.
+
+        @return The number of characters in the view.
+    */
+    int strlen() const {
+        return len_;
+    }
+
+    /*!
+        @brief  Gets the character stored at an index.
+
+        @param  i
+                The index.
+
+        @return The character stored at that index.
+                This method has undefined behaviour if i is out of bounds.
+    */
+    char const & operator[](int const & i) const {
+        return str_[i];
+    }
+
+    /*!
+        @brief  Compares a string to the characters of this view for equality.
+
+        @param  str
+                The string to compare to.
+
+        @return True if the two strings are the same, false otherwise.
+    */
+    bool operator==(char const * str) const {
+        for (int i = 0; i < len_; ++i) {
+            if (str[i] != str_[i]) {
+                return false;
+            }
+        }
+        return str[len_] == '\0';
+    }
+
+    /*!
+        @brief  Checks if the view starts with a string.
+
+        @param  str
+                The string to look for.
+
+        @param  start
+                The index in the view to look from. Optional parameter, default is 0.
+
+        @return True if the characters from start match the whole string,
+                false otherwise.
+    */
+    bool starts_with(char const * str, int const & start = 0) const {
+        for (int i = 0; str[i] != '\0'; ++i) {
+            if (start + i >= len_ || str_[start + i] != str[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+        @brief  Searches for a character within this view.
+
+        @param  c
+                The character to search for.
+
+        @param  start
+                The index to start searching. Optional parameter, default is 0.
+
+        @return The index where the character can be found,
+                or -1 if it cannot be found.
+    */
+    int find(char const & c, int const & start = 0) const {
+        for (int i = start; i < len_; ++i) {
+            if (str_[i] == c) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /*!
+        @brief  Generates a view of part of this view.
+                The part is specified by its starting
+                and ending indices.
+
+        @param  begin
+                The starting index of the part.
+
+        @param  end
+                One past the ending index of the part.
+                Default is -1 to end at the end of this view.
+
+        @return The view of the part.
+    */
+    StringView substr_ii(int const & begin = 0, int end = -1) const {
+        if (end == -1 || end > len_) {
+            end = len_;
+        }
+        return StringView(str_ + begin, end > begin ? end - begin : 0);
+    }
+
+private:
+    char const * str_ = "";
+    int len_ = 0;
+};
+
+} // namespace kty
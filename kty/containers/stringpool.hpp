@@ -1,5 +1,7 @@
 #pragma once
 
+#include <kty/containers/instance_ref.hpp>
+#include <kty/log.hpp>
 #include <kty/sizes.hpp>
 #include <kty/types.hpp>
 
@@ -8,9 +10,15 @@ namespace kty {
 /*!
     @brief  Class that maintains all the strings in the program.
             The memory pool is created on the stack to avoid heap fragmentation.
-            Holds enough memory to allocate N strings of at most length S.            
+            Holds up to N strings of at most length S, whose characters
+            are packed together into B bytes.
+            Each string only takes as many bytes as it needs, plus a small
+            header holding its length, and grows when it is written to.
+            The bytes of released strings are reclaimed by compacting
+            the strings that are still in use, so the pointer returned by
+            c_str() is only valid until the next write to the pool.
 */
-template <int N = Sizes::stringpool_size, int S = Sizes::string_length>
+template <int N = Sizes::stringpool_size, int S = Sizes::string_length, int B = Sizes::stringpool_bytes>
 class StringPool {
 
 public:
@@ -18,9 +26,23 @@ public:
         @brief  Constructor for the string pool
     */
     StringPool() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        memset((void*)pool_, '\0', N * (S + 1));
-        memset((void*)refCount_, 0, N * sizeof(int));
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        memset((void*)heap_, 0, sizeof(heap_));
+        // Chain every index into the free list, lowest index first
+        for (int i = 0; i < N; ++i) {
+            set_next_free(i, i + 1 < N ? i + 1 : -1);
+            blockOf_[i] = -1;
+            nextInterned_[i] = notInterned_;
+        }
+        heapTop_ = 0;
+        heapTaken_ = 0;
+        maxHeapTaken_ = 0;
+        empty_ = '\0';
+        for (int i = 0; i < numInternBuckets_; ++i) {
+            internHead_[i] = -1;
+        }
+        interning_ = true;
+        freeHead_ = 0;
         numTaken_ = 0;
         maxNumTaken_ = 0;
     }
@@ -29,22 +51,63 @@ public:
         @brief  Prints stats about the string pool.
     */
     void stat() const {
-        Log.notice(F("%s: num taken = %d, max num taken = %d\n"), PRINT_FUNC, numTaken_, maxNumTaken_);
+        KTY_LOG_NOTICE(F("%s: num taken = %d, max num taken = %d\n"), PRINT_FUNC, numTaken_, maxNumTaken_);
+        KTY_LOG_NOTICE(F("%s: bytes taken = %d, max bytes taken = %d\n"), PRINT_FUNC, bytes_taken(), max_bytes_taken());
     }
 
     /*!
         @brief  Resets the stats about the string pool.
     */
     void reset_stat() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         maxNumTaken_ = numTaken_;
+        maxHeapTaken_ = heapTaken_;
+    }
+
+    /*!
+        @brief  Gets the number of indices currently taken.
+
+        @return The number of indices currently taken.
+    */
+    int num_taken() const {
+        return numTaken_;
+    }
+
+    /*!
+        @brief  Gets the highest number of indices taken at once since
+                construction or the last call to reset_stat().
+
+        @return The highest number of indices taken at once.
+    */
+    int max_num_taken() const {
+        return maxNumTaken_;
+    }
+
+    /*!
+        @brief  Gets the number of bytes currently taken by strings,
+                including their headers.
+
+        @return The number of bytes currently taken.
+    */
+    int bytes_taken() const {
+        return heapTaken_ * sizeof(heap_[0]);
+    }
+
+    /*!
+        @brief  Gets the highest number of bytes taken by strings at once
+                since construction or the last call to reset_stat().
+
+        @return The highest number of bytes taken at once.
+    */
+    int max_bytes_taken() const {
+        return maxHeapTaken_ * sizeof(heap_[0]);
     }
 
     /*!
         @brief  Prints the addresses used by the string database
     */
     void dump_addresses() const {
-        Log.notice(F("%s: Pool addresses = %d to %d\n"), PRINT_FUNC, (intptr_t)pool_, (intptr_t)(pool_ + N * (S + 1) - 1));
+        KTY_LOG_NOTICE(F("%s: Pool addresses = %d to %d\n"), PRINT_FUNC, (intptr_t)heap_, (intptr_t)(heap_ + numHeapWords_) - 1);
     }
 
     /*!
@@ -53,7 +116,7 @@ public:
         @return The maximum possible string length.
     */
     int max_str_len() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return S;
     }
 
@@ -66,7 +129,7 @@ public:
         @return True if the index is owned by this pool, false otherwise.
     */
     bool owns(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return idx >= 0 && idx < N;
     }
 
@@ -76,7 +139,7 @@ public:
         @return The number of available blocks left in the pool.
     */
     int available() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return N - numTaken_;
     }
 
@@ -90,11 +153,11 @@ public:
                 If the index is invalid, -1 is returned.
     */
     int ref_count(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (idx >=0 && idx < N) {
-            return refCount_[idx];
+            return is_free(idx) ? 0 : refCount_[idx];
         }
-        Log.warning(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+        KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
         return -1;
     }
 
@@ -108,21 +171,23 @@ public:
                 If the address is invalid, -1 is returned.
     */
     int inc_ref_count(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (idx >=0 && idx < N) {
+            if (is_free(idx)) {
+                take_free(idx);
+            }
             ++refCount_[idx];
             return refCount_[idx];
         }
-        Log.warning(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+        KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
         return -1;
     }
 
     /*!
         @brief  Decreases the reference count for an index.
                 If this operation decreases the reference count to 0,
-                it is not deallocated.
-                To ensure that a decrease to 0 deallocates the index,
-                call deallocate_idx().
+                the index is returned to the pool, the same as a final
+                call to deallocate_idx().
 
         @param  idx
                 The index to decrease the reference count for.
@@ -131,38 +196,44 @@ public:
                 If the address is invalid, -1 is returned.
     */
     int dec_ref_count(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (idx >=0 && idx < N) {
+            if (is_free(idx)) {
+                KTY_LOG_WARNING(F("%s: Index %d is already free\n"), PRINT_FUNC, idx);
+                return 0;
+            }
             --refCount_[idx];
+            if (refCount_[idx] == 0) {
+                unreferenced(idx);
+                return 0;
+            }
             return refCount_[idx];
         }
-        Log.warning(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+        KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
         return -1;
     }
 
     /*!
         @brief  Gets the next free index for a string.
+                Indices are taken from the head of the free list,
+                so allocation does not depend on how full the pool is.
+                The new string is empty, and takes no bytes until it is
+                written to.
     
         @return An index into the pool if there is space,
                 -1 otherwise.
     */
     int allocate_idx() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        for (int i = 0; i < N; ++i) {
-            if (refCount_[i] == 0) {
-                ++refCount_[i];
-                ++numTaken_;
-                Log.trace(F("%s: Allocating index %d\n"), PRINT_FUNC, i);
-                memset((void*)(pool_ + (i * (S + 1))), '\0', S + 1);
-                if (numTaken_ > maxNumTaken_) {
-                    maxNumTaken_ = numTaken_;
-                    Log.trace(F("%s: new maxNumTaken %d\n"), PRINT_FUNC, maxNumTaken_);
-                }
-                return i;
-            }
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (freeHead_ == -1) {
+            KTY_LOG_WARNING(F("%s: No more string indices to allocate\n"), PRINT_FUNC);
+            return -1;
         }
-        Log.warning(F("%s: No more string indices to allocate\n"), PRINT_FUNC);
-        return -1;
+        int idx = freeHead_;
+        take_free(idx);
+        ++refCount_[idx];
+        KTY_LOG_TRACE(F("%s: Allocating index %d\n"), PRINT_FUNC, idx);
+        return idx;
     }
 
     /*!
@@ -174,25 +245,25 @@ public:
         @return True if the deallocation was successful, false otherwise.
     */
     bool deallocate_idx(int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (idx < 0 || idx >= N) {
-            Log.warning(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+            KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
             return false;
         }
-        if (refCount_[idx] > 0) {
+        if (!is_free(idx)) {
             --refCount_[idx];
         }
         else {
-            Log.warning(F("%s: Index %d has already been previously deallocated\n"), PRINT_FUNC, idx);
+            KTY_LOG_WARNING(F("%s: Index %d has already been previously deallocated\n"), PRINT_FUNC, idx);
             return false;
         }
         if (refCount_[idx] == 0) {
-            --numTaken_;
-            Log.trace(F("%s: Index %d deallocated successfully\n"), PRINT_FUNC, idx);                
+            unreferenced(idx);
+            KTY_LOG_TRACE(F("%s: Index %d deallocated successfully\n"), PRINT_FUNC, idx);                
             return true;
         }
         else {
-            Log.trace(F("%s: Index %d is not the last reference\n"), PRINT_FUNC, idx);
+            KTY_LOG_TRACE(F("%s: Index %d is not the last reference\n"), PRINT_FUNC, idx);
             return true;
         }
     }
@@ -207,11 +278,15 @@ public:
                 The stored string.
     */
     char * c_str(int const & idx) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         if (idx >= 0 && idx < N) {
-            return const_cast<char *>(pool_) + (idx * (S + 1));
+            if (blockOf_[idx] == -1) {
+                empty_ = '\0';
+                return &empty_;
+            }
+            return block_str(blockOf_[idx]);
         }
-        Log.warning(F("%s: Index %d is invalid, index range is [0, %d]\n"), PRINT_FUNC, idx, N - 1);
+        KTY_LOG_WARNING(F("%s: Index %d is invalid, index range is [0, %d]\n"), PRINT_FUNC, idx, N - 1);
         return nullptr;
     }
 
@@ -231,16 +306,53 @@ public:
                 Default is index 0.
     */
     void strcpy(int const & idx, char const * str, int const & i = 0) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (idx < 0 || idx >= N) {
+            KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+            return;
+        }
         int copyStrLen = ::strlen(str);
-        int lenToCopy = (S < copyStrLen ? S : copyStrLen) - i;
-        ::strncpy(c_str(idx) + i, str, lenToCopy);
-        *(c_str(idx) + i + lenToCopy) = '\0';
+        int lenToCopy = reserve(idx, S < copyStrLen ? S : copyStrLen, str) - i;
+        if (lenToCopy < 0) {
+            return;
+        }
+        char * dst = c_str(idx) + i;
+        ::memmove(dst, str, lenToCopy);
+        dst[lenToCopy] = '\0';
+        set_len(idx, i + lenToCopy);
+    }
+
+    /*!
+        @brief  Sets a string in the database from a number of characters,
+                which do not need to be null terminated.
+
+        @param  idx
+                The database index for the string.
+
+        @param  str
+                The incoming characters.
+
+        @param  len
+                The number of characters to copy.
+    */
+    void strncpy(int const & idx, char const * str, int const & len) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (idx < 0 || idx >= N) {
+            KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+            return;
+        }
+        int lenToCopy = reserve(idx, S < len ? S : len, str);
+        char * dst = c_str(idx);
+        ::memmove(dst, str, lenToCopy);
+        dst[lenToCopy] = '\0';
+        set_len(idx, lenToCopy);
     }
 
     /*!
         @brief  Concatenates another string to the end of a string
                 in the pool.
+                The string is appended at its stored length,
+                without scanning the characters already in it.
 
         @param  idx
                 The database index for the string.
@@ -249,19 +361,486 @@ public:
                 The incoming string which will be concatenated onto the end.
     */
     void strcat(int const & idx, char const * str) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        int currLen = ::strlen(c_str(idx));
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (idx < 0 || idx >= N) {
+            KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+            return;
+        }
+        int currLen = strlen(idx);
         int catStrLen = ::strlen(str);
         // Length to cat is minimum of remaining space and length of string to cat
         int lenToCat = ((S - currLen) < catStrLen ? (S - currLen) : catStrLen);
-        Log.verbose(F("%s: length to cat %d\n"), PRINT_FUNC, lenToCat);
-        strncpy(c_str(idx) + currLen, str, lenToCat);
-        *(c_str(idx) + currLen + lenToCat) = '\0';
+        lenToCat = reserve(idx, currLen + lenToCat, str) - currLen;
+        KTY_LOG_VERBOSE(F("%s: length to cat %d\n"), PRINT_FUNC, lenToCat);
+        char * dst = c_str(idx) + currLen;
+        ::memmove(dst, str, lenToCat);
+        dst[lenToCat] = '\0';
+        set_len(idx, currLen + lenToCat);
+    }
+
+    /*!
+        @brief  Gets the length of a string in the pool.
+                The length is stored with the string, so this does not
+                scan its characters, unless they were written to directly
+                since the length was last known.
+
+        @param  idx
+                The database index for the string.
+
+        @return The length of the string.
+                If the index is invalid, -1 is returned.
+    */
+    int strlen(int const & idx) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (idx < 0 || idx >= N) {
+            KTY_LOG_WARNING(F("%s: Index %d did not come from pool\n"), PRINT_FUNC, idx);
+            return -1;
+        }
+        int block = blockOf_[idx];
+        if (block == -1) {
+            return 0;
+        }
+        if (heap_[block + 2] == -1) {
+            heap_[block + 2] = ::strlen(block_str(block));
+        }
+        return heap_[block + 2];
+    }
+
+    /*!
+        @brief  Marks the stored length of a string as unknown.
+                This must be called after writing to the characters of a
+                string directly through c_str(), since the pool cannot see
+                such writes.
+                The length is found again by the next call to strlen().
+
+        @param  idx
+                The database index for the string.
+    */
+    void invalidate_len(int const & idx) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (idx >= 0 && idx < N && blockOf_[idx] != -1) {
+            heap_[blockOf_[idx] + 2] = -1;
+        }
+    }
+
+    /*!
+        @brief  Turns interning on or off.
+                While interning is off, intern_idx() always allocates a new index.
+
+        @param  interning
+                True to turn interning on, false to turn it off.
+    */
+    void set_interning(bool const & interning) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        interning_ = interning;
+    }
+
+    /*!
+        @brief  Checks if interning is on.
+
+        @return True if interning is on, false otherwise.
+    */
+    bool interning() const {
+        return interning_;
+    }
+
+    /*!
+        @brief  Gets an interned index holding a string.
+                If an interned index already holds the same string,
+                its reference count is increased and it is returned.
+                Otherwise a new index is allocated, filled and interned.
+                Interned indices are shared, and must not be modified.
+
+        @param  str
+                The string to intern.
+
+        @return An interned index holding the string if there is space
+                for all of it, -1 otherwise.
+    */
+    int intern_idx(char const * str) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int bucket = intern_bucket(str);
+        if (interning_) {
+            for (int i = internHead_[bucket]; i != -1; i = nextInterned_[i]) {
+                if (::strncmp(c_str(i), str, S) == 0) {
+                    ++refCount_[i];
+                    return i;
+                }
+            }
+        }
+        int len = ::strlen(str);
+        int idx = allocate_idx();
+        if (idx == -1) {
+            return -1;
+        }
+        strcpy(idx, str);
+        // A string cut short by a full heap would sit in the bucket of the whole string
+        if (strlen(idx) < (len < S ? len : S)) {
+            KTY_LOG_WARNING(F("%s: No more bytes to intern %s\n"), PRINT_FUNC, str);
+            deallocate_idx(idx);
+            return -1;
+        }
+        if (interning_) {
+            nextInterned_[idx] = internHead_[bucket];
+            internHead_[bucket] = idx;
+        }
+        return idx;
+    }
+
+    /*!
+        @brief  Checks if an index is interned.
+
+        @param  idx
+                The index to check.
+
+        @return True if the index is interned, false otherwise.
+    */
+    bool is_interned(int const & idx) const {
+        return idx >= 0 && idx < N && nextInterned_[idx] != notInterned_;
     }
 
 private:
-    char pool_[N * (S + 1)];
+    /*!
+        @brief  Removes an index from the free list and marks it as taken.
+
+        @param  idx
+                The free index.
+    */
+    void take_free(int const & idx) {
+        if (freeHead_ == idx) {
+            freeHead_ = next_free(idx);
+        }
+        else {
+            // Only reached when reviving an index through inc_ref_count()
+            int prev = freeHead_;
+            while (prev != -1 && next_free(prev) != idx) {
+                prev = next_free(prev);
+            }
+            if (prev != -1) {
+                set_next_free(prev, next_free(idx));
+            }
+        }
+        refCount_[idx] = 0;
+        ++numTaken_;
+        if (numTaken_ > maxNumTaken_) {
+            maxNumTaken_ = numTaken_;
+            KTY_LOG_TRACE(F("%s: new maxNumTaken %d\n"), PRINT_FUNC, maxNumTaken_);
+        }
+    }
+
+    /*!
+        @brief  Gets the characters stored in a block of the heap.
+
+        @param  block
+                The word offset of the block.
+
+        @return The characters of the block.
+    */
+    char * block_str(int const & block) const {
+        return reinterpret_cast<char *>(const_cast<short *>(heap_ + block + headerWords_));
+    }
+
+    /*!
+        @brief  Stores the length of a string, if it has a block.
+
+        @param  idx
+                The index.
+
+        @param  len
+                The length of the string.
+    */
+    void set_len(int const & idx, int const & len) {
+        if (blockOf_[idx] != -1) {
+            heap_[blockOf_[idx] + 2] = len;
+        }
+    }
+
+    /*!
+        @brief  Gets the number of heap words a string needs.
+
+        @param  len
+                The length of the string.
+
+        @return The number of words, including the header.
+    */
+    static int words_for(int const & len) {
+        return headerWords_ + (len + sizeof(heap_[0])) / sizeof(heap_[0]);
+    }
+
+    /*!
+        @brief  Gets the longest string that fits in a number of heap words.
+
+        @param  words
+                The number of words, including the header.
+
+        @return The length of the longest string.
+    */
+    static int len_for(int const & words) {
+        return (words - headerWords_) * sizeof(heap_[0]) - 1;
+    }
+
+    /*!
+        @brief  Makes room for a string of a given length at an index,
+                keeping the characters it already holds.
+                The string is grown in place if it is the last block of the
+                heap, and moved to the top of the heap otherwise.
+                If the heap is too full, the strings in use are compacted
+                first.
+
+        @param  idx
+                The index.
+
+        @param  len
+                The length to make room for.
+
+        @param  str
+                A string that is about to be copied to the index.
+                If it is stored in the heap and compaction moves it,
+                it is updated to point to its new place.
+
+        @return The length that there is room for, which is less than len
+                if the heap is full.
+    */
+    int reserve(int const & idx, int const & len, char const * & str) {
+        int block = blockOf_[idx];
+        int blockWords = block == -1 ? 0 : heap_[block + 1];
+        int words = words_for(len);
+        if (words <= blockWords || (block == -1 && len == 0)) {
+            return len;
+        }
+        bool isLast = block != -1 && block + blockWords == heapTop_;
+        if ((isLast ? block : heapTop_) + words > numHeapWords_) {
+            compact(str);
+            block = blockOf_[idx];
+            isLast = block != -1 && block + blockWords == heapTop_;
+        }
+        int room = numHeapWords_ - (isLast ? block : heapTop_);
+        if (words > room) {
+            KTY_LOG_WARNING(F("%s: No more string bytes to allocate, string will be truncated\n"), PRINT_FUNC);
+            words = room;
+            if (!isLast && (words <= blockWords || words <= headerWords_)) {
+                return block == -1 ? 0 : len_for(blockWords);
+            }
+        }
+        if (isLast) {
+            // Grow the last block of the heap in place
+            heap_[block + 1] = words;
+            heapTop_ = block + words;
+            take_heap(words - blockWords);
+        }
+        else {
+            int newBlock = heapTop_;
+            heap_[newBlock] = idx;
+            heap_[newBlock + 1] = words;
+            heapTop_ += words;
+            take_heap(words);
+            if (block != -1) {
+                int oldLen = heap_[block + 2] == -1 ? len_for(blockWords) : heap_[block + 2];
+                heap_[newBlock + 2] = heap_[block + 2];
+                ::memcpy(block_str(newBlock), block_str(block), oldLen + 1);
+                free_block(block);
+            }
+            else {
+                heap_[newBlock + 2] = 0;
+                *block_str(newBlock) = '\0';
+            }
+            blockOf_[idx] = newBlock;
+        }
+        return len < len_for(words) ? len : len_for(words);
+    }
+
+    /*!
+        @brief  Slides every block still in use down to the bottom of the heap,
+                so that all the free bytes are together at the top.
+
+        @param  str
+                A string which is updated to point to its new place,
+                if it is stored in the heap.
+    */
+    void compact(char const * & str) {
+        KTY_LOG_TRACE(F("%s: Compacting %d words\n"), PRINT_FUNC, heapTop_);
+        char const * heapStr = reinterpret_cast<char const *>(heap_);
+        int strByte = str >= heapStr && str < heapStr + sizeof(heap_) ? str - heapStr : -1;
+        int dst = 0;
+        for (int block = 0; block < heapTop_; ) {
+            int words = heap_[block + 1];
+            if (heap_[block] != -1) {
+                if (strByte >= block * (int)sizeof(heap_[0]) && strByte < (block + words) * (int)sizeof(heap_[0])) {
+                    str -= (block - dst) * sizeof(heap_[0]);
+                }
+                if (dst != block) {
+                    ::memmove(heap_ + dst, heap_ + block, words * sizeof(heap_[0]));
+                    blockOf_[heap_[dst]] = dst;
+                }
+                dst += words;
+            }
+            block += words;
+        }
+        heapTop_ = dst;
+    }
+
+    /*!
+        @brief  Releases a block of the heap.
+                The last block is given back straight away, any other block
+                is marked as free until the next compaction.
+
+        @param  block
+                The word offset of the block.
+    */
+    void free_block(int const & block) {
+        heapTaken_ -= heap_[block + 1];
+        if (block + heap_[block + 1] == heapTop_) {
+            heapTop_ = block;
+        }
+        else {
+            heap_[block] = -1;
+        }
+    }
+
+    /*!
+        @brief  Counts heap words as taken, for the stats.
+
+        @param  words
+                The number of words.
+    */
+    void take_heap(int const & words) {
+        heapTaken_ += words;
+        if (heapTaken_ > maxHeapTaken_) {
+            maxHeapTaken_ = heapTaken_;
+        }
+    }
+
+    /*!
+        @brief  Gets the intern bucket for a string,
+                from a hash of the characters that fit in an index.
+
+        @param  str
+                The string.
+
+        @return The intern bucket.
+    */
+    static int intern_bucket(char const * str) {
+        unsigned int hash = 0;
+        for (int i = 0; i < S && str[i] != '\0'; ++i) {
+            hash = hash * 31 + (unsigned char)str[i];
+        }
+        return hash % numInternBuckets_;
+    }
+
+    /*!
+        @brief  Removes an interned index from its intern bucket.
+
+        @param  idx
+                The index.
+    */
+    void unintern(int const & idx) {
+        int * link = &internHead_[intern_bucket(c_str(idx))];
+        while (*link != idx) {
+            link = &nextInterned_[*link];
+        }
+        *link = nextInterned_[idx];
+        nextInterned_[idx] = notInterned_;
+    }
+
+    /*!
+        @brief  Pushes an index whose reference count has reached 0
+                onto the front of the free list.
+
+        @param  idx
+                The index to release.
+    */
+    void release(int const & idx) {
+        set_next_free(idx, freeHead_);
+        freeHead_ = idx;
+        --numTaken_;
+    }
+
+    /*!
+        @brief  Checks if an index is in the free list.
+
+        @param  idx
+                The index.
+
+        @return True if the index is free, false otherwise.
+    */
+    bool is_free(int const & idx) const {
+        return refCount_[idx] < 0;
+    }
+
+    /*!
+        @brief  Gets the free index after a free index.
+
+        @param  idx
+                The free index.
+
+        @return The next free index, -1 at the end of the list.
+    */
+    int next_free(int const & idx) const {
+        return -2 - refCount_[idx];
+    }
+
+    /*!
+        @brief  Puts an index in the free list, in front of another free index.
+
+        @param  idx
+                The index.
+
+        @param  next
+                The next free index, -1 at the end of the list.
+    */
+    void set_next_free(int const & idx, int const & next) {
+        refCount_[idx] = -2 - next;
+    }
+
+    /*!
+        @brief  Handles an index whose reference count has reached 0,
+                freeing its block and returning it to the free list.
+
+        @param  idx
+                The index.
+    */
+    void unreferenced(int const & idx) {
+        if (nextInterned_[idx] != notInterned_) {
+            unintern(idx);
+        }
+        if (blockOf_[idx] != -1) {
+            free_block(blockOf_[idx]);
+            blockOf_[idx] = -1;
+        }
+        release(idx);
+    }
+
+    /** Number of words in the heap */
+    static const int numHeapWords_ = (B + sizeof(short) - 1) / sizeof(short);
+    /** Number of words at the start of each block, holding its index, its size in words
+        and the length of its string, -1 if the length is unknown */
+    static const int headerWords_ = 3;
+    /** Blocks of characters for each string, one after the other */
+    short heap_[numHeapWords_];
+    /** Word offset of the block for each index, -1 for an empty string with no block */
+    int blockOf_[N];
+    /** Number of heap words used by blocks, free or not */
+    int heapTop_;
+    /** Number of heap words taken by blocks in use */
+    int heapTaken_;
+    int maxHeapTaken_;
+    /** Returned for strings with no block */
+    mutable char empty_;
+    /** The reference count of each taken index. A free index holds the next
+        free index instead, as -2 - index, so it is always negative */
     int refCount_[N];
+    /** Number of hash buckets that interned indices are kept in */
+    static const int numInternBuckets_ = 32;
+    /** First interned index in each bucket, -1 if there are none */
+    int internHead_[numInternBuckets_];
+    /** Held in nextInterned_ by an index that is not interned */
+    static const int notInterned_ = -2;
+    /** Next interned index in the same bucket as each interned index, -1 for the last one */
+    int nextInterned_[N];
+    /** Whether intern_idx() shares indices */
+    bool interning_;
+    /** First free index, -1 if the pool is full */
+    int freeHead_;
     int numTaken_;
     int maxNumTaken_;
 
@@ -284,6 +863,17 @@ StringPool<Sizes::stringpool_size, Sizes::string_length> * get_stringpool(String
     return stringPool;
 }
 
+/*!
+    @brief  Specialisation of DefaultGetFunc that makes get_stringpool the function
+            used by containers that are not told where their string pool is.
+*/
+template <>
+struct DefaultGetFunc<decltype(get_stringpool)> {
+    static decltype(get_stringpool) & get() {
+        return get_stringpool;
+    }
+};
+
 /*!
     @brief  Class to perform setup of the get_stringpool function at the global scope.
 */
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <kty/containers/string.hpp>
+#include <kty/log.hpp>
+#include <kty/types.hpp>
+#include <kty/utils.hpp>
+
+namespace kty {
+
+/*!
+    @brief  A name resolved to an entry of a symbol table ahead of time,
+            so that the entry can be reached again without searching.
+            Each entry carries a generation that changes whenever a name
+            is added to or removed from it, so a binding made before such
+            a change is no longer current and must be made again.
+            A binding is only meaningful to the table that made it.
+*/
+class SymbolBinding {
+
+public:
+    /*!
+        @brief  Constructor for a binding to no entry, which is never current.
+    */
+    SymbolBinding() {
+    }
+
+    /*!
+        @brief  Constructor for a binding.
+
+        @param  slot
+                The entry of the table.
+
+        @param  generation
+                The generation of the entry when the binding was made.
+    */
+    SymbolBinding(int const & slot, unsigned int const & generation)
+        : slot_(slot), generation_(generation) {
+    }
+
+    /*!
+        @brief  Gets the entry of the table.
+
+        @return The slot of the entry, or -1 if the binding is to no entry.
+    */
+    int slot() const {
+        return slot_;
+    }
+
+    /*!
+        @brief  Gets the generation of the entry when the binding was made.
+
+        @return The generation.
+    */
+    unsigned int generation() const {
+        return generation_;
+    }
+
+private:
+    short slot_ = -1;
+    unsigned short generation_ = 0;
+
+};
+
+/*!
+    @brief  Table from names to values with a fixed capacity.
+            Provides lookup and insertion in constant time on average,
+            however many names are held.
+            Implemented as an open addressing hash table of N entries stored
+            inside the object, probed linearly, so it never allocates, and
+            inserting a new name into a full table fails.
+            The hash of each name is stored with its entry, so names are
+            only compared when their hashes match.
+            Names cannot be removed one at a time, only all together.
+            A name can be bound to its entry with bind(), and the binding
+            used in place of the name until the entry changes.
+
+    @tparam Value
+            The type of value stored for each name.
+
+    @tparam N
+            The number of entries, which must be a power of two.
+
+    @tparam PoolString
+            The type of string used for the names.
+*/
+template <typename Value, int N, typename PoolString = PoolString<>>
+class SymbolTable {
+
+public:
+    /** The type of value stored in the table */
+    typedef Value value_t;
+
+    /*!
+        @brief  Constructor for the table.
+    */
+    SymbolTable() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        static_assert(N > 0 && (N & (N - 1)) == 0, "SymbolTable<Value, N> must have a capacity that is a power of two.");
+    }
+
+    /*!
+        @brief  Returns the number of names in the table.
+
+        @return The number of names in the table.
+    */
+    int size() const {
+        return size_;
+    }
+
+    /*!
+        @brief  Returns the most names the table can hold.
+
+        @return The capacity of the table.
+    */
+    int capacity() const {
+        return N;
+    }
+
+    /*!
+        @brief  Returns true if the table is empty, false otherwise.
+
+        @return True if the table is empty, false otherwise.
+    */
+    bool is_empty() const {
+        return size_ == 0;
+    }
+
+    /*!
+        @brief  Returns true if the table is full, false otherwise.
+
+        @return True if the table is full, false otherwise.
+    */
+    bool is_full() const {
+        return size_ == N;
+    }
+
+    /*!
+        @brief  Removes all names from the table, releasing their strings.
+    */
+    void clear() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        for (int i = 0; i < N; ++i) {
+            if (entries_[i].hash != 0) {
+                entries_[i].name = PoolString();
+                entries_[i].value = value_t();
+                entries_[i].hash = 0;
+                ++entries_[i].generation;
+            }
+        }
+        size_ = 0;
+    }
+
+    /*!
+        @brief  Finds the value for a name.
+
+        @param  name
+                The name to find.
+
+        @return A pointer to the value, or nullptr if the name is not in the table.
+                The pointer stays valid until the table is cleared.
+    */
+    value_t * find(PoolString const & name) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int i = probe(name, hash(name.c_str()));
+        if (i == -1 || entries_[i].hash == 0) {
+            return nullptr;
+        }
+        return &entries_[i].value;
+    }
+
+    /*!
+        @brief  Finds the value for a name.
+
+        @param  name
+                The name to find.
+
+        @return A pointer to the value, or nullptr if the name is not in the table.
+    */
+    value_t const * find(PoolString const & name) const {
+        return const_cast<SymbolTable *>(this)->find(name);
+    }
+
+    /*!
+        @brief  Binds a name to the entry that holds it, or to the unused
+                entry it would take if it is not in the table yet.
+                Adding the name later changes that entry, so the binding
+                stops being current then.
+
+        @param  name
+                The name to bind.
+
+        @return The binding, which is to no entry if the name is not in
+                the table and the table is full.
+    */
+    SymbolBinding bind(PoolString const & name) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int i = probe(name, hash(name.c_str()));
+        if (i == -1) {
+            return SymbolBinding();
+        }
+        return SymbolBinding(i, entries_[i].generation);
+    }
+
+    /*!
+        @brief  Checks if a binding still refers to what its name did when it was made.
+
+        @param  binding
+                The binding made by this table.
+
+        @return True if the entry has not changed since the binding was made,
+                false otherwise.
+    */
+    bool is_current(SymbolBinding const & binding) const {
+        return binding.slot() >= 0 && binding.slot() < N && entries_[binding.slot()].generation == binding.generation();
+    }
+
+    /*!
+        @brief  Finds the value for a bound name, without searching.
+
+        @param  binding
+                A current binding made by this table.
+
+        @return A pointer to the value, or nullptr if the name was not in
+                the table when bound, or the binding is not current.
+    */
+    value_t const * find(SymbolBinding const & binding) const {
+        if (!is_current(binding) || entries_[binding.slot()].hash == 0) {
+            return nullptr;
+        }
+        return &entries_[binding.slot()].value;
+    }
+
+    /*!
+        @brief  Sets the value for a name, adding the name if it is not in the table.
+                Added names are interned, so they share an index with equal names.
+
+        @param  name
+                The name to set.
+
+        @param  value
+                The value for the name.
+
+        @return A pointer to the value in the table,
+                or nullptr if the name is new and the table is full.
+    */
+    value_t * insert(PoolString const & name, value_t const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        unsigned int nameHash = hash(name.c_str());
+        int i = probe(name, nameHash);
+        if (i == -1) {
+            KTY_LOG_WARNING(F("%s: Unable to insert %s, table is full at %d\n"), PRINT_FUNC, name.c_str(), N);
+            return nullptr;
+        }
+        Entry & entry = entries_[i];
+        if (entry.hash == 0) {
+            entry.name = name;
+            entry.name.intern();
+            entry.hash = nameHash;
+            ++entry.generation;
+            ++size_;
+        }
+        entry.value = value;
+        return &entry.value;
+    }
+
+    /*!
+        @brief  Gets the hash of a name.
+                The characters are mixed so that names which only differ
+                in their last characters, such as n1 and n2, still land
+                in entries far apart.
+
+        @param  str
+                The name.
+
+        @return The hash, which is never 0.
+    */
+    static unsigned int hash(char const * str) {
+        unsigned int hash = 0;
+        for (int i = 0; str[i] != '\0'; ++i) {
+            hash = hash * 31 + (unsigned char)str[i];
+        }
+        hash *= 40503u;
+        hash ^= hash >> (sizeof(hash) * 4);
+        return hash == 0 ? 1 : hash;
+    }
+
+private:
+    /*!
+        @brief  An entry of the table.
+                A hash of 0 marks an unused entry.
+    */
+    struct Entry {
+        PoolString name;
+        value_t value = value_t();
+        unsigned int hash = 0;
+        unsigned short generation = 0;
+    };
+
+    /*!
+        @brief  Finds the entry for a name, or the unused entry it would take.
+
+        @param  name
+                The name to find.
+
+        @param  nameHash
+                The hash of the name.
+
+        @return The index of the entry, or -1 if the name is not in the table
+                and the table is full.
+    */
+    int probe(PoolString const & name, unsigned int const & nameHash) const {
+        int i = nameHash & (N - 1);
+        for (int numProbed = 0; numProbed < N; ++numProbed, i = (i + 1) & (N - 1)) {
+            Entry const & entry = entries_[i];
+            if (entry.hash == 0 || (entry.hash == nameHash && entry.name == name)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /** The entries of the table */
+    Entry entries_[N];
+    /** The number of names in the table */
+    int size_ = 0;
+
+};
+
+} // namespace kty
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <kty/bytecode.hpp>
+#include <kty/compiler.hpp>
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/deque.hpp>
 #include <kty/containers/deque_of_deque.hpp>
+#include <kty/containers/ring_deque.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/machine_state.hpp>
 #include <kty/parser.hpp>
 #include <kty/string_utils.hpp>
@@ -44,9 +48,8 @@ public:
               commandQueue_(getAllocFunc), commandBuffer_(getAllocFunc),
               machineState_(getAllocFunc, getPoolFunc),
               lastGroupName_(getPoolFunc),
-              lastCondition_(getAllocFunc),
               parser_(getAllocFunc, getPoolFunc), tokenizer_(getAllocFunc, getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         status_ = InterpreterStatus::NORMAL;
         currScopeLevel_ = 0;          // Start at scope level 0
         lastCondition_.push_back(-1); // Last condition at scope level 0 = null
@@ -58,7 +61,7 @@ public:
                 Essentially starting the interpreter from the beginning.
     */
     void reset() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         status_ = InterpreterStatus::NORMAL;
         currScopeLevel_ = 0;
         lastCondition_[currScopeLevel_] = -1;
@@ -66,6 +69,10 @@ public:
         lastGroupName_ = "";
         machineState_.reset();
         commandQueue_.clear();
+        frames_.clear();
+        fromFrame_ = false;
+        releasePending_ = false;
+        blockFromFrame_ = false;
         commandBuffer_.clear();
     }
 
@@ -76,7 +83,7 @@ public:
                 If there is no required prefix, an empty string is returned.
     */
     PoolString get_prompt_prefix() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         PoolString prefix(*getPoolFunc_);
         switch (status_) {
         case NORMAL:
@@ -106,7 +113,7 @@ public:
         @return True if the number exists, false otherwise.
     */
     bool number_exists(PoolString const & name) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         return machineState_.number_exists(name);
     }
 
@@ -119,7 +126,7 @@ public:
         @return True if the device exists, false otherwise.
     */
     bool device_exists(PoolString const & name) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         return machineState_.device_exists(name);
     }
 
@@ -132,7 +139,7 @@ public:
         @return True if the group exists, false otherwise.
     */
     int group_exists(PoolString const & name) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         return machineState_.group_exists(name);
     }
 
@@ -146,7 +153,7 @@ public:
                 Returns 0 if it does not exist.
     */
     int get_number_value(PoolString const & name) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         return machineState_.get_number_value(name);        
     }
 
@@ -160,7 +167,7 @@ public:
                 Returns an unknown device if it does not exist.
     */
     DeviceType get_device_type(PoolString const & name) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         return machineState_.get_device_type(name);        
     }
 
@@ -177,7 +184,7 @@ public:
                 Returns -1 if it does not exist.
     */
     int get_device_info(PoolString const & name, int const & idx) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return machineState_.get_device_info(name, idx);
     }
 
@@ -191,7 +198,7 @@ public:
                 If the group does not exist, an empty deque is returned.
     */
     Deque<PoolString> get_group_commands(PoolString const & name) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);        
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);        
         return machineState_.get_group_commands(name);        
     }
 
@@ -205,7 +212,7 @@ public:
     */
     void execute(PoolString command) {
         remove_str_multiple_whitespace(command);
-        commandQueue_.push_back(command);
+        commandQueue_.push_back(move(command));
         execute_command_queue();
     }
 
@@ -216,27 +223,33 @@ public:
                 command queue, those commands will not be run yet.
                 execute_command_queue() must be called after this to run those
                 commands.
+                The tokens and strings taken from the allocator and string pool
+                while compiling and running the command are all given back
+                before this returns. Only new names and the commands of the
+                blocks and groups being created are kept.
 
         @param  command
                 The command to execute.
+
+        @param  code
+                The compiled code of the command, which is run in place of
+                the command when no block or group is being created,
+                or nullptr to compile the command first.
     */
-    void execute_single_command(PoolString const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    void execute_single_command(PoolString const & command, unsigned char * code = nullptr) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Nothing to execute
         if (command.strlen() == 0) {
             return;
         }
-        // Check for special interpreter-only commands
-        if (command == "DecreaseScopeLevel") {
-            --currScopeLevel_;
-            return;
-        }
-        Deque<Token> tokens;
         switch (status_) {
         case NORMAL:
-            tokens = tokenizer_.tokenize(command);
-            tokens = parser_.parse(tokens);
-            execute_command_tokens(tokens);
+            if (code == nullptr) {
+                code = compile(command);
+            }
+            if (code != nullptr) {
+                run_code(code);
+            }
             break;
         case CREATING_IF:
             add_to_if(command);
@@ -251,481 +264,398 @@ public:
     }
 
     /*!
-        @brief  Executes all the commands still in the command queue, if any.
+        @brief  Executes all the commands still in the command queue, if any,
+                and those of the frames still running.
+                Commands queued after a frame started running go before the
+                rest of that frame, the same as if the frame had been queued.
     */
     void execute_command_queue() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        while (!commandQueue_.is_empty()) {
-            PoolString command(commandQueue_.front());
-            commandQueue_.pop_front();
-            execute_single_command(command);
-        }
-    }
-
-    /*!
-        @brief  Executes a given command in the form of tokens.
-
-        @param  command
-                The command to execute.
-                Tokens in command are assumed to be in postfix notation.
-    */
-    void execute_command_tokens(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (command.back().is_if()) {
-            execute_if(command);
-        }
-        else if (command.back().is_else()) {
-            execute_else(command);
-        }
-        else {
-            // For every other command, last condition at this scope level becomes null
-            lastCondition_[currScopeLevel_] = -1;
-            if (command.back().is_print()) {
-                execute_print(command);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        while (true) {
+            if (!frames_.is_empty() && commandQueue_.size() == frames_.back().queueSize) {
+                PoolString command(*getPoolFunc_);
+                unsigned char * code = nullptr;
+                if (next_frame_command(command, code)) {
+                    fromFrame_ = true;
+                    execute_single_command(command, code);
+                }
             }
-            else if (command.back().is_wait()) {
-                execute_wait(command);
+            else if (!commandQueue_.is_empty()) {
+                PoolString command(move(commandQueue_.front()));
+                commandQueue_.pop_front();
+                fromFrame_ = false;
+                execute_single_command(command);
             }
-            else if (command.front().is_name()) {
-                // Printing information
-                if (command.size() == 1) {
-                    execute_print_info(command);
-                }
-                // Creation of a device/group
-                else if (command.back().is_create_num() || 
-                         command.back().is_create_led() || 
-                         command.back().is_create_group()) {
-                    execute_create(command);
-                }
-                else if (command.back().is_move_by() ||
-                         command.back().is_move_by_for()) {
-                    execute_move_by(command);
-                }
-                else if (command.back().is_set_to() ||
-                         command.back().is_set_to_for()) {
-                    execute_set_to(command);
-                }
-                // Running group
-                else {
-                    execute_run_group(command);
-                }
+            else {
+                break;
             }
-            else if (command.front().is_string()) {
-                execute_print_string(command);
+            if (releasePending_) {
+                release_old_groups();
             }
         }
     }
 
     /*!
-        @brief  Executes the more general print command.
+        @brief  Prints the information about a name.
 
-        @param  command
-                The command to execute
-    */
-    void execute_print(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokens(command);
-        tokens.pop_back();
-        tokens = evaluate_postfix(tokens);
-        for (typename Deque<Token>::Iterator it = tokens.begin(); it != tokens.end(); ++it) {
-            Serial.print(it->get_value().c_str());
-        }
-        Serial.println("");
-    }
+        @param  symbol
+                The handle of the name.
 
-    /*!
-        @brief  Executes the wait command.
-
-        @param  command
-                The command to execute
-    */
-    void execute_wait(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokens(command);
-        tokens.pop_back();
-        tokens = evaluate_postfix(tokens);
-        delay(get_token_value(tokens.back()));
-    }
-
-    /*!
-        @brief  Executes the print information command.
-
-        @param  command
-                The command to execute.
+        @param  name
+                The name.
     */
-    void execute_print_info(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        PoolString name(command.front().get_value());
-        if (number_exists(name)) {
-            Serial.print(name.c_str());
+    void print_info(Symbol const & symbol, char const * name) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (symbol.is_number()) {
+            Serial.print(name);
             Serial.print(F(": number storing "));
-            Serial.println(get_number_value(name));
+            Serial.println(machineState_.get_number_value(symbol));
         }
-        else if (device_exists(name)) {
-            switch (get_device_type(name)) {
+        else if (symbol.is_device()) {
+            switch (machineState_.get_device_type(symbol)) {
             case LED:
-                Serial.print(name.c_str());
+                Serial.print(name);
                 Serial.print(F(": LED using pin "));
-                Serial.print(get_device_info(name, 1));
+                Serial.print(machineState_.get_device_info(symbol, 1));
                 Serial.print(F(" at "));
-                Serial.print(get_device_info(name, 2));
+                Serial.print(machineState_.get_device_info(symbol, 2));
                 Serial.println(F("%"));                
             };
         }
-        else if (group_exists(name)) {
-            Serial.print(name.c_str());
+        else if (symbol.is_group()) {
+            Serial.print(name);
             Serial.println(F(": group containing the command(s) "));
-            int nameLen = name.strlen();
-            Deque<PoolString> groupCommands = get_group_commands(name);
-            for (typename Deque<PoolString>::Iterator it = groupCommands.begin(); it != groupCommands.end(); ++it) {
+            int nameLen = ::strlen(name);
+            for (int i = 0; i < machineState_.get_group_size(symbol); ++i) {
                 // Print out enough spaces to line up vertically with the end of
                 // the name of the group
                 for (int j = 0; j < nameLen; ++j) {
                     Serial.print(F(" "));
                 }
-                Serial.println(it->c_str());
+                Serial.println(machineState_.get_group_command(symbol, i).c_str());
             }
         }
         else {
             Serial.print(F("Error: "));
-            Serial.print(name.c_str());
+            Serial.print(name);
             Serial.println(F(" does not exist"));
         }
     }
 
     /*!
-        @brief  Executes the if command.
+        @brief  Moves a number or device by a displacement.
 
-        @param  command
-                The command to execute.
-    */
-    void execute_if(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokenQueue(command);
-        // Skip the if token at the end
-        tokenQueue.pop_back();
-        Deque<Token> result = evaluate_postfix(tokenQueue);
-        create_if(get_token_value(result.back()));
-    }
+        @param  symbol
+                The handle of the number or device.
 
-    /*!
-        @brief  Executes the else command.
+        @param  name
+                The name of the number or device.
 
-        @param  command
-                The command to execute.
-    */
-    void execute_else(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        // No condition to extract for else, immediately create group
-        create_else();
-    }
+        @param  displacement
+                The displacement.
 
-    /*!
-        @brief  Executes the different creation commands.
+        @param  isFor
+                Whether to move back once the duration is over.
 
-        @param  command
-                The command to execute.
+        @param  durationMs
+                The duration in milliseconds, if isFor is true.
     */
-    void execute_create(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokenQueue(command);
-        // Skip the create token at the end
-        Token createToken = tokenQueue.back();
-        tokenQueue.pop_back();
-        PoolString name(tokenQueue.front().get_value());
-        tokenQueue.pop_front();
-
-        Deque<Token> result = evaluate_postfix(tokenQueue);
-
-        if (createToken.is_create_num()) {
-            create_number(name, result);
-        }
-        else if (createToken.is_create_led()) {
-            create_led(name, result);
-        }
-        else if (createToken.is_create_group()) {
-            create_group(name);
+    void move_by(Symbol const & symbol, char const * name, int const & displacement, bool const & isFor, int const & durationMs) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // Nothing to move
+        if (!symbol.is_number() && !symbol.is_device()) {
+            Serial.print(F("Error: "));
+            Serial.print(name);
+            Serial.println(F(" does not exist"));
+            return;
         }
+        int value = symbol.is_number() ? machineState_.get_number_value(symbol) + displacement
+                                       : machineState_.get_device_info(symbol, 2) + displacement;
+        set(symbol, value, isFor, durationMs);
     }
 
     /*!
-        @brief  Executes the move by or move by for commands.
+        @brief  Sets a number or device to a value.
 
-        @param  command
-                The command to execute.
+        @param  symbol
+                The handle of the number or device.
+
+        @param  name
+                The name of the number or device.
+
+        @param  newValue
+                The value.
+
+        @param  isFor
+                Whether to set back the old value once the duration is over.
+
+        @param  durationMs
+                The duration in milliseconds, if isFor is true.
     */
-    void execute_move_by(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokenQueue(command);
-        Token moveByToken = tokenQueue.back();
-        tokenQueue.pop_back();
-        PoolString name(tokenQueue.front().get_value());
-        tokenQueue.pop_front();
-        // Nothing to move
-        if (!number_exists(name) && !device_exists(name)) {
+    void set_to(Symbol const & symbol, char const * name, int const & newValue, bool const & isFor, int const & durationMs) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // Nothing to set
+        if (!symbol.is_number() && !symbol.is_device()) {
             Serial.print(F("Error: "));
-            Serial.print(name.c_str());
+            Serial.print(name);
             Serial.println(F(" does not exist"));
             return;
         }
+        set(symbol, newValue, isFor, durationMs);
+    }
 
-        // Evaluate arguments
-        Deque<Token> result = evaluate_postfix(tokenQueue);
-        int displacement, durationMs = 0;
-        // There will be an additional argument if it is move by for
-        if (moveByToken.is_move_by_for()) {
-            durationMs = get_token_value(result.back());
-            result.pop_back();
-        }
-        displacement = get_token_value(result.back());
-
-        // Execute move
-        int value = get_number_value(name);
-        int deviceInfo1 = get_device_info(name, 1);
-        int deviceInfo2 = get_device_info(name, 2);
-        if (number_exists(name)) {
-            machineState_.set_number(name, value + displacement);
+    /*!
+        @brief  Sets an existing number or device to a value,
+                shared by moving and setting.
+
+        @param  symbol
+                The handle of the number or device.
+
+        @param  newValue
+                The value.
+
+        @param  isFor
+                Whether to set back the old value once the duration is over.
+
+        @param  durationMs
+                The duration in milliseconds, if isFor is true.
+    */
+    void set(Symbol const & symbol, int const & newValue, bool const & isFor, int const & durationMs) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int value = machineState_.get_number_value(symbol);
+        int deviceInfo1 = machineState_.get_device_info(symbol, 1);
+        int deviceInfo2 = machineState_.get_device_info(symbol, 2);
+        if (symbol.is_number()) {
+            machineState_.set_number(symbol, newValue);
         }
         else {
-            switch (get_device_type(name)) {
+            switch (machineState_.get_device_type(symbol)) {
             case LED:
-                int brightness = deviceInfo2 + displacement;
+                int brightness = newValue;
                 if (brightness > 100) {
-                    Log.notice(F("%s: LED brightness over 100%, maximum is 100%\n"), PRINT_FUNC);
+                    KTY_LOG_NOTICE(F("%s: LED brightness over 100%, maximum is 100%\n"), PRINT_FUNC);
                     brightness = 100;
                 }
                 else if (brightness < 0) {
-                    Log.notice(F("%s: LED brightness below 0%, minimum is 0%\n"), PRINT_FUNC);
+                    KTY_LOG_NOTICE(F("%s: LED brightness below 0%, minimum is 0%\n"), PRINT_FUNC);
                     brightness = 0;
                 }
                 analogWrite(deviceInfo1, brightness * 2.55);
-                machineState_.set_device(name, DeviceType::LED, -1, deviceInfo1, brightness);
+                machineState_.set_device(symbol, DeviceType::LED, -1, deviceInfo1, brightness);
             };
         }
-        // MoveByFor command
-        if (moveByToken.is_move_by_for()) {
+        if (isFor) {
             // Additional time delay
             delay(durationMs);
             // Then set back to original value
-            if (number_exists(name)) {
-                machineState_.set_number(name, value);
+            if (symbol.is_number()) {
+                machineState_.set_number(symbol, value);
             }
             else {
-                switch (get_device_type(name)) {
+                switch (machineState_.get_device_type(symbol)) {
                 case LED:
                     analogWrite(deviceInfo1, deviceInfo2 * 2.55);
-                    machineState_.set_device(name, DeviceType::LED, -1, deviceInfo1, deviceInfo2);
+                    machineState_.set_device(symbol, DeviceType::LED, -1, deviceInfo1, deviceInfo2);
                 };
             }
         }
     }
 
     /*!
-        @brief  Executes the set to or set to for commands.
+        @brief  Runs a command group.
+                Essentially pushes a frame over the commands in the command
+                group, which are read in place and executed later, before the
+                rest of the command queue.
 
-        @param  command
-                The command to execute.
+        @param  symbol
+                The handle of the group.
+
+        @param  name
+                The name of the group.
+
+        @param  numTimes
+                The number of times to run the group, or -1 to run it forever.
     */
-    void execute_set_to(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokenQueue(command);
-        Token setToToken = tokenQueue.back();
-        tokenQueue.pop_back();
-        PoolString name(tokenQueue.front().get_value());
-        tokenQueue.pop_front();
-        // Nothing to set
-        if (!number_exists(name) && !device_exists(name)) {
-            Serial.print(F("Error: "));
-            Serial.print(name.c_str());
-            Serial.println(F(" does not exist"));
+    void run_group(Symbol const & symbol, char const * name, int const & numTimes) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group()) {
+            KTY_LOG_WARNING(F("%s: %s does not exist\n"), PRINT_FUNC, name);
             return;
         }
-        // Evaluate arguments
-        Deque<Token> result = evaluate_postfix(tokenQueue);
-        int newValue, durationMs = 0;
-        // There will be an additional argument if it is set to for
-        if (setToToken.is_set_to_for()) {
-            durationMs = get_token_value(result.back());
-            result.pop_back();
+        // Only run the group at least once, or continuously
+        if (numTimes != -1 && numTimes <= 0) {
+            return;
         }
-        newValue = get_token_value(result.back());
-
-        // Execute set
-        int value = get_number_value(name);
-        int deviceInfo1 = get_device_info(name, 1);
-        int deviceInfo2 = get_device_info(name, 2);
-        if (number_exists(name)) {
-            machineState_.set_number(name, newValue);
+        // A frame that has nothing left to run is done, so this group takes its place
+        while (!frames_.is_empty() && commandQueue_.size() == frames_.back().queueSize &&
+               frames_.back().pc >= frames_.back().end && frames_.back().timesLeft == 0 &&
+               frames_.back().scopeLevel == currScopeLevel_) {
+            pop_frame();
         }
-        else {
-            switch (get_device_type(name)) {
-            case LED:
-                int brightness = newValue;
-                if (brightness > 100) {
-                    Log.notice(F("%s: LED brightness over 100%, maximum is 100%\n"), PRINT_FUNC);
-                    brightness = 100;
-                }
-                else if (brightness < 0) {
-                    Log.notice(F("%s: LED brightness below 0%, minimum is 0%\n"), PRINT_FUNC);
-                    brightness = 0;
-                }
-                analogWrite(deviceInfo1, brightness * 2.55);
-                machineState_.set_device(name, DeviceType::LED, -1, deviceInfo1, brightness);
-            };
-        }
-        // SetToFor command
-        if (setToToken.is_set_to_for()) {
-            // Additional time delay
-            delay(durationMs);
-            // Then set back to original value
-            if (number_exists(name)) {
-                machineState_.set_number(name, value);
-            }
-            else {
-                switch (get_device_type(name)) {
-                case LED:
-                    analogWrite(deviceInfo1, deviceInfo2 * 2.55);
-                    machineState_.set_device(name, DeviceType::LED, -1, deviceInfo1, deviceInfo2);
-                };
-            }
+        push_frame(symbol, 0, machineState_.get_group_size(symbol), numTimes == -1 ? -1 : numTimes - 1);
+    }
+
+    /*!
+        @brief  Pushes a frame that runs commands of a group,
+                on top of the command queue as it is now.
+
+        @param  group
+                The handle of the group, or a handle to nothing for a frame
+                that only waits for the commands queued in front of it.
+
+        @param  begin
+                The index of the first command of the group to run.
+
+        @param  end
+                The index after the last command of the group to run.
+
+        @param  timesLeft
+                The number of times to run the commands after the first time,
+                or -1 to run them forever.
+
+        @return True if successful, false if too many frames are running.
+    */
+    bool push_frame(Symbol const & group, int const & begin, int const & end, int const & timesLeft) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (frames_.is_full()) {
+            Serial.print(F("Error: unable to run more than "));
+            Serial.print(frames_.capacity());
+            Serial.println(F(" groups and If or Else blocks inside each other"));
+            return false;
         }
+        Frame frame;
+        frame.group = group;
+        frame.begin = begin;
+        frame.pc = begin;
+        frame.end = end;
+        frame.timesLeft = timesLeft;
+        frame.scopeLevel = currScopeLevel_;
+        frame.queueSize = commandQueue_.size();
+        frames_.push_back(frame);
+        return true;
     }
 
     /*!
-        @brief  Executes the running of a command group.
-                Essentially adds the commands in the command group to the
-                command queue to be executed later.
+        @brief  Moves the innermost frame on to its next command, starting
+                its commands over or popping it when it runs out.
+                Popping a frame returns to the scope level it started at.
 
         @param  command
-                The command to execute.
+                Set to the next command of the frame, which shares the index
+                of the stored command in the string pool.
+
+        @param  code
+                Set to the compiled code of the next command,
+                or nullptr if it has none.
+
+        @return True if there is a command to execute, false otherwise.
     */
-    void execute_run_group(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokenQueue(command);
-        // Remove RunGroup command from back
-        tokenQueue.pop_back();
-        // Extract name of group and check if it exists
-        PoolString name(tokenQueue.front().get_value());
-        if (!group_exists(name)) {
-            Log.warning(F("%s: %s does not exist\n"), PRINT_FUNC, name.c_str());
-            return;
+    bool next_frame_command(PoolString & command, unsigned char *& code) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Frame & frame = frames_.back();
+        if (frame.pc < frame.end) {
+            command = machineState_.get_group_command(frame.group, frame.pc);
+            code = machineState_.get_group_code(frame.group, frame.pc);
+            ++frame.pc;
+            return true;
         }
-        // Extract number of times to run group
-        Deque<Token> result = evaluate_postfix(tokenQueue);
-        int numTimes = get_token_value(result.back());
-        // Push command for one more call to run the group
-        if (numTimes > 1) {
-            commandQueue_.push_front(PoolString(*getPoolFunc_));
-            commandQueue_.front() += name.c_str();
-            commandQueue_.front() += "RunGroup(";
-            commandQueue_.front() += int_to_str(numTimes - 1, *getPoolFunc_);
-            commandQueue_.front() += ")";
+        if (frame.timesLeft == 0) {
+            currScopeLevel_ = frame.scopeLevel;
+            pop_frame();
+            return false;
         }
-        // Continuously run the group
-        else if (numTimes == -1) {
-            commandQueue_.push_front(PoolString(*getPoolFunc_));
-            commandQueue_.front() += name.c_str();
-            commandQueue_.front() += "RunGroup(-1)";
+        if (frame.timesLeft > 0) {
+            --frame.timesLeft;
         }
-        // If running group at least once(or continuously)
-        if (numTimes == -1 || numTimes > 0) {
-            Deque<PoolString> groupCommands = get_group_commands(name);
-            // Push from the last command to ensure correct order
-            typename Deque<PoolString>::Iterator it = groupCommands.end();
-            --it;
-            for ( ; it != groupCommands.begin(); --it) {
-                commandQueue_.push_front(*it);
-            }
-            // Additional push for the first command (not handled by loop)
-            commandQueue_.push_front(*it);
+        frame.pc = frame.begin;
+        // A group that was redefined while it ran starts over with its new commands
+        Symbol group = machineState_.get_current_group(frame.group);
+        if (group.slot() != frame.group.slot()) {
+            frame.group = group;
+            frame.end = machineState_.get_group_size(group);
+            releasePending_ = true;
         }
+        return false;
     }
 
     /*!
-        @brief  Executes the printing of a string.
-
-        @param  command
-                The print string command to execute.
+        @brief  Pops the innermost frame.
+                The old commands of a group that was redefined while it ran
+                are released later, by release_old_groups(), since the code
+                being run may be among the commands of the groups.
     */
-    void execute_print_string(Deque<Token> const & command) {
-        Serial.println(command.front().get_value().c_str());
+    void pop_frame() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol group = frames_.back().group;
+        frames_.pop_back();
+        if (machineState_.get_current_group(group).slot() != group.slot()) {
+            releasePending_ = true;
+        }
     }
 
     /*!
-        @brief  Evaluates a postfix expression.
+        @brief  Checks if any frame runs commands of a group.
 
-        @param  tokenQueue
-                The postfix expression to be evaluated.
+        @param  group
+                The handle of the group.
 
-        @return The result stack after evaluation is complete.
-                The stack may contain multiple values, depending on the input expression.
+        @return True if the group is running, false otherwise.
     */
-    Deque<Token> evaluate_postfix(Deque<Token> const & tokenQueue) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokenStack;
-
-        for (typename Deque<Token>::ConstIterator it = tokenQueue.begin(); it != tokenQueue.end(); ++it) {
-            Token const & token = *it;
-            if (token.is_unary_operator()) {
-                Token operand = tokenStack.back();
-                tokenStack.pop_back();
-                Token result = evaluate_unary_operation(token, operand);
-                tokenStack.push_back(result);
-            }
-            else if (token.is_operator()) {
-                Token rhs = tokenStack.back();
-                tokenStack.pop_back();
-                Token lhs = tokenStack.back();
-                tokenStack.pop_back();
-                Token result = evaluate_operation(token, lhs, rhs);
-                tokenStack.push_back(result);
-            }
-            else if (token.is_operand()) {
-                // Instantly evaluate
-                tokenStack.push_back(Token(TokenType::NUM_VAL, int_to_str(get_token_value(token))));
+    bool is_running(Symbol const & group) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        for (int i = 0; i < frames_.size(); ++i) {
+            if (frames_[i].group.is_group() && frames_[i].group.slot() == group.slot()) {
+                return true;
             }
-            // Everything else just goes directly to the tokenStack
-            else {
-                tokenStack.push_back(token);
+        }
+        return false;
+    }
+
+    /*!
+        @brief  Releases the old commands of the groups that were redefined
+                while they ran, and that no frame runs any more.
+                Must not be called while code is being run, since releasing
+                commands moves the code of the other groups.
+    */
+    void release_old_groups() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        for (int i = 0; i < Sizes::max_num_groups + 1; ++i) {
+            Symbol group(GROUP_SYMBOL, i);
+            if (machineState_.get_current_group(group).slot() != i && !is_running(group)) {
+                machineState_.release_group(group);
             }
         }
-        return tokenStack;
+        releasePending_ = false;
     }
 
     /*!
-        @brief  Evaluates single unary operation.
+        @brief  Evaluates single unary operation on a value.
 
         @param  operation
-                The operation to be applied.
+                The type of the operator token.
         
-        @param  operand
-                The operand to be operated on.
+        @param  value
+                The operand.
 
-        @return The result of performing the operation.
-                If any of the arguments are invalid, 
-                a token containing "0" is returned.
+        @return The result of performing the operation,
+                or 0 if the operation is not a unary operation.
     */
-    Token evaluate_unary_operation(Token const & operation, Token const & operand) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        int value = get_token_value(operand);
-        Token result(TokenType::NUM_VAL);
-        result.set_value(int_to_str(0));
-        
-        if (operation.is_unary_neg()) {
-            result.set_value(int_to_str(-value));
-        }
-        else if (operation.is_logi_not()) {
-            result.set_value(int_to_str(!value));
+    int evaluate_unary(TokenType const & operation, int const & value) {
+        switch (operation) {
+        case UNARY_NEG:
+            return -value;
+        case LOGI_NOT:
+            return !value;
+        default:
+            return 0;
         }
-
-        return result;
     }
 
     /*!
-        @brief  Evaluates single binary operation.
+        @brief  Evaluates single binary operation on values.
 
         @param  operation
-                The operation to be applied.
+                The type of the operator token.
         
         @param  lhs
                 The left hand side operand.
@@ -733,57 +663,40 @@ public:
         @param  rhs
                 The right hand side operand.
 
-        @return The result of performing the operation.
-                If any of the arguments are invalid, 
-                a token containing "0" is returned.
+        @return The result of performing the operation,
+                or 0 if the operation is not supported.
     */
-    Token evaluate_operation(Token const & operation, Token const & lhs, Token const & rhs) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        int lhsValue = get_token_value(lhs);
-        int rhsValue = get_token_value(rhs);
-        Token result(TokenType::NUM_VAL);
-        result.set_value(int_to_str(0));
-
-        if (operation.is_equals()) {
-            result.set_value(int_to_str(lhsValue == rhsValue));
-        }
-        else if (operation.is_l_equals()) {
-            result.set_value(int_to_str(lhsValue <= rhsValue));
-        }
-        else if (operation.is_g_equals()) {
-            result.set_value(int_to_str(lhsValue >= rhsValue));
-        }
-        else if (operation.is_less()) {
-            result.set_value(int_to_str(lhsValue < rhsValue));
-        }
-        else if (operation.is_greater()) {
-            result.set_value(int_to_str(lhsValue > rhsValue));
-        }
-        else if (operation.is_math_add()) {
-            result.set_value(int_to_str(lhsValue + rhsValue));
+    int evaluate_binary(TokenType const & operation, int const & lhs, int const & rhs) {
+        switch (operation) {
+        case EQUALS:
+            return lhs == rhs;
+        case L_EQUALS:
+            return lhs <= rhs;
+        case G_EQUALS:
+            return lhs >= rhs;
+        case LESS:
+            return lhs < rhs;
+        case GREATER:
+            return lhs > rhs;
+        case MATH_ADD:
+            return lhs + rhs;
+        case MATH_SUB:
+            return lhs - rhs;
+        case MATH_MUL:
+            return lhs * rhs;
+        case MATH_DIV:
+            return lhs / rhs;
+        case MATH_MOD:
+            return lhs % rhs;
+        case MATH_POW:
+            return power(lhs, rhs);
+        case LOGI_AND:
+            return lhs && rhs;
+        case LOGI_OR:
+            return lhs || rhs;
+        default:
+            return 0;
         }
-        else if (operation.is_math_sub()) {
-            result.set_value(int_to_str(lhsValue - rhsValue));
-        }
-        else if (operation.is_math_mul()) {
-            result.set_value(int_to_str(lhsValue * rhsValue));
-        }
-        else if (operation.is_math_div()) {
-            result.set_value(int_to_str(lhsValue / rhsValue));
-        }
-        else if (operation.is_math_mod()) {
-            result.set_value(int_to_str(lhsValue % rhsValue));
-        }
-        else if (operation.is_math_pow()) {
-            result.set_value(int_to_str(power(lhsValue, rhsValue)));
-        }
-        else if (operation.is_logi_and()) {
-            result.set_value(int_to_str(lhsValue && rhsValue));
-        }
-        else if (operation.is_logi_or()) {
-            result.set_value(int_to_str(lhsValue || rhsValue));
-        }
-        return result;
     }
 
     /*!
@@ -805,48 +718,26 @@ public:
         return result;
     }
 
-    /*!
-        @brief  Returns the value of a token.
-
-        @param  token
-                The token to be evaluated.
-
-        @return The value of the token.
-                If the token is a number, that number is returned.
-                If the token is a device, the status value of the device is returned.
-                Otherwise, 0 is returned.
-    */
-    int get_token_value(Token const & token) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        if (token.is_num_val()) {
-            return str_to_int(token.get_value());
-        }
-        else if (token.is_name()) {
-            PoolString name(token.get_value());
-            if (number_exists(name)) {
-                return get_number_value(name);
-            }
-            else if (device_exists(name)) {
-                return get_device_info(name, 2);
-            }
-        }
-        return 0;
-    }
-
     /*!
         @brief  Creates a number using the name and information given.
 
         @param  name
                 The name of the number to be created
+
+        @param  symbol
+                The handle of the name, which refers to nothing if the name is new.
         
-        @param  info
-                The information about the number.
-                The number value is expected to be the top token of the stack.
+        @param  value
+                The value of the number.
     */
-    void create_number(PoolString const & name, Deque<Token> & info) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        int value = str_to_int(info.back().get_value());
-        machineState_.set_number(name, value);     
+    void create_number(char const * name, Symbol const & symbol, int const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        PoolString newName(*getPoolFunc_);
+        bool created = symbol.exists() ? machineState_.set_number(symbol, value)
+                                       : copy_name(name, newName) && machineState_.set_number(newName, value);
+        if (!created) {
+            report_not_created(name);
+        }
     }
 
     /*!
@@ -854,37 +745,108 @@ public:
 
         @param  name
                 The name of the LED to be created
+
+        @param  symbol
+                The handle of the name, which refers to nothing if the name is new.
         
-        @param  info
-                The information about the LED.
-                The LED brightness value is expected to be the top token of the stack,
-                and the LED pin number is expected to be the second token from the top.
+        @param  pinNumber
+                The pin number of the LED.
+
+        @param  brightness
+                The brightness of the LED.
     */
-    void create_led(PoolString const & name, Deque<Token> & info) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        int brightness = str_to_int(info.back().get_value());
-        info.pop_back();
-        int pinNumber = str_to_int(info.back().get_value());
+    void create_led(char const * name, Symbol const & symbol, int const & pinNumber, int const & brightness) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         pinMode(pinNumber, OUTPUT);
         analogWrite(pinNumber, (int)(brightness * 2.55));
-        machineState_.set_device(name, DeviceType::LED, -1, pinNumber, brightness);
+        PoolString newName(*getPoolFunc_);
+        bool created = symbol.exists() ? machineState_.set_device(symbol, DeviceType::LED, -1, pinNumber, brightness)
+                                       : copy_name(name, newName) && machineState_.set_device(newName, DeviceType::LED, -1, pinNumber, brightness);
+        if (!created) {
+            report_not_created(name);
+        }
+    }
+
+    /*!
+        @brief  Copies a new name to a string in the string pool.
+
+        @param  name
+                The name.
+
+        @param  str
+                The string to copy the name to.
+
+        @return True if all of the name fit in the string pool, false otherwise.
+    */
+    bool copy_name(char const * name, PoolString & str) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // The name may be moved by the pool while it is copied, so only its length is compared after
+        int len = ::strlen(name);
+        str = name;
+        return str.strlen() == len;
+    }
+
+    /*!
+        @brief  Reports that a name could not be created.
+                A name that already exists as another kind keeps its old
+                meaning, and an error saying what it is is printed.
+                Otherwise there was no space left for it.
+
+        @param  name
+                The name that could not be created.
+    */
+    void report_not_created(char const * name) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol symbol = machineState_.lookup(PoolString(*getPoolFunc_, name));
+        if (!symbol.exists()) {
+            Serial.print(F("Error: no space for "));
+            Serial.println(name);
+            return;
+        }
+        Serial.print(F("Error: "));
+        Serial.print(name);
+        if (symbol.is_number()) {
+            Serial.println(F(" is already a number"));
+        }
+        else if (symbol.is_group()) {
+            Serial.println(F(" is already a group"));
+        }
+        else if (machineState_.get_device_type(symbol) == DeviceType::LED) {
+            Serial.println(F(" is already an LED"));
+        }
+        else {
+            Serial.println(F(" is already a device"));
+        }
     }
 
     /*!
         @brief  Begins the creation of an if command group.
+                An if block of a running frame whose end is known is run
+                or skipped in place, without reading its commands first.
 
         @param  condition
                 The result of evaluating the condition.
+
+        @param  blockEnd
+                The index of the ')' that closes the block within the group
+                of the running frame, or -1 if it is not known.
     */
-    void create_if(int const & condition) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        enter_scope(InterpreterStatus::CREATING_IF);
+    void create_if(int const & condition, int const & blockEnd = -1) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Expand lastCondition_ if necessary
         while (lastCondition_.size() <= currScopeLevel_ + 1) {
-            lastCondition_.push_back(-1);
+            if (!lastCondition_.push_back(-1)) {
+                break;
+            }
         }
         lastCondition_[currScopeLevel_] = !!condition;
+        if (fromFrame_ && blockEnd != -1) {
+            run_block_in_place(blockEnd, condition);
+            return;
+        }
+        enter_scope(InterpreterStatus::CREATING_IF);
         ++currScopeLevel_;
+        begin_block();
     }
 
     /*!
@@ -894,21 +856,20 @@ public:
                 The command to add to the if command group.
     */
     void add_to_if(PoolString const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> tokens = tokenizer_.tokenize(command);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Group is closed
-        if (bracketParity_ == 0 && tokens.size() == 2 && tokens.front().is_cl_paren()) {
+        if (bracketParity_ == 0 && closes_block(command)) {
             close_if();
         }
         // Add command to group
         else {
-            commandBuffer_.push_back(command);
+            add_to_block(command);
             // Check if command introduces a '('
-            if (tokens[tokens.size() - 2].is_op_paren()) {
+            if (opens_block(command)) {
                 ++bracketParity_;
             }
             // Check if command is a single ')'
-            else if (tokens.size() == 2 && tokens.front().is_cl_paren()) {
+            else if (closes_block(command)) {
                 --bracketParity_;
             }
         }
@@ -916,39 +877,46 @@ public:
 
     /*!
         @brief  Finishes the creation of an if command group,
-                and adds its commands to the commandQueue if the condition is true.
+                and runs its commands if the condition is true.
     */
     void close_if() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         int condition = lastCondition_[currScopeLevel_ - 1];
+        --currScopeLevel_;
         if (condition) {
-            // Special interpreter-only command to ensure we decrease scope level
-            // after all the instructions in the if block are done
-            commandQueue_.push_front(PoolString("DecreaseScopeLevel", *getPoolFunc_));
-            // Add commands to commandQueue in reverse order,
-            // since pushing from the front
-            while (!commandBuffer_.is_empty()) {
-                commandQueue_.push_front(commandBuffer_.back());
-                commandBuffer_.pop_back();
-            }
-        }
-        else {
-            --currScopeLevel_;
+            run_block();
         }
         exit_scope();
     }
 
     /*!
         @brief  Begins the creation of an else command group.
+                An else block of a running frame whose end is known is run
+                or skipped in place, without reading its commands first.
+
+        @param  blockEnd
+                The index of the ')' that closes the block within the group
+                of the running frame, or -1 if it is not known.
     */
-    void create_else() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+    void create_else(int const & blockEnd = -1) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (fromFrame_ && blockEnd != -1) {
+            int condition = lastCondition_[currScopeLevel_];
+            // No else should be run after this
+            lastCondition_[currScopeLevel_] = -1;
+            // Only run if last condition was false
+            run_block_in_place(blockEnd, condition == 0);
+            return;
+        }
         enter_scope(InterpreterStatus::CREATING_ELSE);
         // Expand lastCondition_ if necessary
         while (lastCondition_.size() <= currScopeLevel_ + 1) {
-            lastCondition_.push_back(-1);
+            if (!lastCondition_.push_back(-1)) {
+                break;
+            }
         }
         ++currScopeLevel_;
+        begin_block();
     }
 
     /*!
@@ -958,21 +926,20 @@ public:
                 The command to add to the else command group.
     */
     void add_to_else(PoolString const & command) {
-        Log.verbose(F("%s\n"),  PRINT_FUNC);
-        Deque<Token> tokens = tokenizer_.tokenize(command);
+        KTY_LOG_VERBOSE(F("%s\n"),  PRINT_FUNC);
         // Group is closed
-        if (bracketParity_ == 0 && tokens.size() == 2 && tokens.front().is_cl_paren()) {
+        if (bracketParity_ == 0 && closes_block(command)) {
             close_else();
         }
         // Add command to group
         else {
-            commandBuffer_.push_back(command);
+            add_to_block(command);
             // Check if command introduces a '('
-            if (tokens[tokens.size() - 2].is_op_paren()) {
+            if (opens_block(command)) {
                 ++bracketParity_;
             }
             // Check if command closes with a ')'
-            else if (tokens.size() == 2 && tokens.front().is_cl_paren()) {
+            else if (closes_block(command)) {
                 --bracketParity_;
             }
         }
@@ -984,76 +951,218 @@ public:
                 directly follows an if that had a condition which was false.
     */
     void close_else() {
-        Log.verbose(F("%s\n"),  PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"),  PRINT_FUNC);
         int condition = lastCondition_[currScopeLevel_ - 1];
         // No else should be run after this
         lastCondition_[currScopeLevel_ - 1] = -1;
+        --currScopeLevel_;
         // Only run if last condition was false
         if (condition == 0) {
-            // Special interpreter-only command to ensure we decrease scope level
-            // after all the instructions in the if block are done
-            commandQueue_.push_front(PoolString("DecreaseScopeLevel", *getPoolFunc_));
-            // Add commands to commandQueue in reverse order,
-            // since pushing from the front
-            while (!commandBuffer_.is_empty()) {
-                commandQueue_.push_front(commandBuffer_.back());
-                commandBuffer_.pop_back();
-            }
-        }
-        else {
-            --currScopeLevel_;
+            run_block();
         }
         exit_scope();
     }
 
+    /*!
+        @brief  Starts collecting the commands of an if or else block.
+                A block inside a running frame is part of the same stored
+                group, so only where it begins is noted.
+    */
+    void begin_block() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        blockFromFrame_ = fromFrame_;
+        if (blockFromFrame_) {
+            blockBegin_ = frames_.back().pc;
+        }
+    }
+
+    /*!
+        @brief  Adds a command to the if or else block being collected,
+                unless the block is read in place from its group later.
+
+        @param  command
+                The command to add.
+    */
+    void add_to_block(PoolString const & command) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!blockFromFrame_) {
+            commandBuffer_.push_back(command);
+        }
+    }
+
+    /*!
+        @brief  Runs the if or else block that was just collected, one scope
+                level in from the current one, in a frame of its own.
+                A block from a running frame is run from its group in place,
+                up to the ')' that closed it.
+                Any other block is moved to the front of the command queue,
+                with a frame that only waits for it, to leave the scope level
+                when it is done.
+    */
+    void run_block() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        bool pushed = blockFromFrame_ ? push_frame(frames_.back().group, blockBegin_, frames_.back().pc - 1, 0)
+                                      : push_frame(Symbol(), 0, 0, 0);
+        if (!pushed) {
+            return;
+        }
+        ++currScopeLevel_;
+        if (!blockFromFrame_) {
+            // Move the whole block to the front of commandQueue at once
+            commandQueue_.splice_front(commandBuffer_);
+        }
+    }
+
+    /*!
+        @brief  Runs or skips the if or else block that starts at the next
+                command of the innermost frame, in a frame of its own one
+                scope level in from the current one.
+                The innermost frame carries on after the ')' that closes the block.
+
+        @param  blockEnd
+                The index of the ')' that closes the block within the group of the frame.
+
+        @param  toRun
+                Whether to run the block.
+    */
+    void run_block_in_place(int const & blockEnd, bool const & toRun) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int begin = frames_.back().pc;
+        frames_.back().pc = blockEnd + 1;
+        if (toRun && push_frame(frames_.back().group, begin, blockEnd, 0)) {
+            ++currScopeLevel_;
+        }
+    }
+
     /*!
         @brief  Begins the creation of a command group.
+                A group defined by a running frame whose end is known is
+                copied from the group of the frame, with the code of its
+                commands, without reading them one at a time.
 
         @param  name
                 The name of the command group to be created.
+
+        @param  blockEnd
+                The index of the ')' that closes the group within the group
+                of the running frame, or -1 if it is not known.
     */
-    void create_group(PoolString const & name) {
-        Log.verbose(F("%s\n"),  PRINT_FUNC);
+    void create_group(PoolString const & name, int const & blockEnd = -1) {
+        KTY_LOG_VERBOSE(F("%s\n"),  PRINT_FUNC);
+        if (fromFrame_ && blockEnd != -1) {
+            Frame & frame = frames_.back();
+            int begin = frame.pc;
+            frame.pc = blockEnd + 1;
+            machineState_.begin_new_group();
+            bool copied = true;
+            for (int j = begin; j < blockEnd; ++j) {
+                int k = machineState_.copy_to_new_group(frame.group, j);
+                copied = copied && k != -1;
+                // The ends of the blocks inside are moved to where the group begins
+                unsigned char * code = machineState_.get_new_group_code(k);
+                if (code != nullptr && *code == OP_BLOCK) {
+                    unsigned char * operand = ++code;
+                    int end = Bytecode::read_int(code);
+                    Bytecode::write_int(operand, end == -1 || end >= blockEnd ? -1 : end - begin);
+                }
+            }
+            if (!copied) {
+                report_group_full(name);
+            }
+            name_new_group(name);
+            return;
+        }
         enter_scope(InterpreterStatus::CREATING_GROUP);
         lastGroupName_ = name;
+        machineState_.begin_new_group();
     }
 
     /*!
         @brief  Adds a command to the command group that is currently being created.
+                The command is compiled once, here, and a command that opens
+                a block is given the index of the ')' that closes it,
+                so that running the group never looks for the end of a block.
 
         @param  command
                 The command to add to the command group.
     */
     void add_to_group(PoolString const & command) {
-        Log.verbose(F("%s\n"),  PRINT_FUNC);
-        Deque<Token> tokens = tokenizer_.tokenize(command);
-        if (bracketParity_ == 0 && tokens.size() == 2 && tokens.front().is_cl_paren()) {
+        KTY_LOG_VERBOSE(F("%s\n"),  PRINT_FUNC);
+        bool closes = closes_block(command);
+        if (bracketParity_ == 0 && closes) {
             close_group();
+            return;
         }
         // Add command to group
-        else {
-            commandBuffer_.push_back(command);
-            // Check if command introduces a '('
-            if (tokens[tokens.size() - 2].is_op_paren()) {
-                ++bracketParity_;
+        bool opens = opens_block(command);
+        int len = closes ? -1 : compiler_.compile(parser_.parse(tokenizer_.tokenize(command)), opens);
+        // A command whose code does not fit is compiled again when it runs, which reports the error
+        int j = machineState_.add_to_new_group(command, len == -1 ? nullptr : compiler_.code(), len);
+        if (j == -1) {
+            report_group_full(lastGroupName_);
+        }
+        if (opens) {
+            if (bracketParity_ < Sizes::max_scope_depth) {
+                openBlocks_[bracketParity_] = j;
             }
-            // Check if command closes with a ')'
-            else if (tokens.size() == 2 && tokens.front().is_cl_paren()) {
-                --bracketParity_;
+            ++bracketParity_;
+        }
+        else if (closes) {
+            --bracketParity_;
+            unsigned char * code = bracketParity_ < Sizes::max_scope_depth && j != -1 && openBlocks_[bracketParity_] != -1
+                                 ? machineState_.get_new_group_code(openBlocks_[bracketParity_]) : nullptr;
+            if (code != nullptr && *code == OP_BLOCK) {
+                Bytecode::write_int(code + 1, j);
             }
         }
     }
 
+    /*!
+        @brief  Reports that a command could not be added to a group,
+                because there was no space left for it.
+
+        @param  name
+                The name of the group.
+    */
+    void report_group_full(PoolString const & name) {
+        Serial.print(F("Error: no space for more commands in "));
+        Serial.println(name.c_str());
+    }
+
     /*!
         @brief  Finishes the creation of a command group.
     */
     void close_group() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        machineState_.set_group(lastGroupName_, commandBuffer_);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        name_new_group(lastGroupName_);
         lastGroupName_ = "";
         exit_scope();
     }
 
+    /*!
+        @brief  Gives the new group its name.
+                A group that is redefined while it runs finishes running
+                its old commands, and runs its new commands the next time.
+
+        @param  name
+                The name of the group.
+    */
+    void name_new_group(PoolString const & name) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol symbol = machineState_.lookup(name);
+        bool running = symbol.is_group() && is_running(symbol);
+        if (machineState_.set_new_group(name, running)) {
+            return;
+        }
+        if (running) {
+            Serial.print(F("Error: "));
+            Serial.print(name.c_str());
+            Serial.println(F(" is running, no space to redefine it"));
+            return;
+        }
+        report_not_created(name.c_str());
+    }
+
     /*!
         @brief  Sets the interpreter to enter a scope.
 
@@ -1072,26 +1181,283 @@ public:
         commandBuffer_.clear();
     }
 
+    /*!
+        @brief  Compiles a command that is not held by a group.
+
+        @param  command
+                The command.
+
+        @return A pointer to the code, which stays valid until the next
+                command is compiled, or nullptr if the command is too long
+                to compile.
+    */
+    unsigned char * compile(PoolString const & command) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // The tokens are moved from stage to stage, never copied
+        if (compiler_.compile(parser_.parse(tokenizer_.tokenize(command))) == -1) {
+            Serial.print(F("Error: "));
+            Serial.print(command.c_str());
+            Serial.println(F(" is too long"));
+            return nullptr;
+        }
+        return compiler_.code();
+    }
+
+    /*!
+        @brief  Runs the compiled code of a command.
+                Values are kept as ints on a fixed stack, and only turned
+                into text when they are printed, so nothing is allocated
+                unless the command creates a name.
+
+        @param  code
+                The code, whose name bindings are updated in place.
+    */
+    void run_code(unsigned char * code) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        ValueStack stack;
+        unsigned char * pc = code;
+        char const * name = nullptr;
+        int blockEnd = -1;
+        while (true) {
+            OpCode op = (OpCode)*pc++;
+            // For every command other than if and else, last condition at this scope level becomes null
+            if (Bytecode::is_command(op)) {
+                lastCondition_[currScopeLevel_] = -1;
+            }
+            switch (op) {
+            case OP_END:
+                return;
+            case OP_INT:
+                stack.push(Bytecode::read_int(pc));
+                break;
+            case OP_NAME: {
+                Symbol symbol = lookup(pc, name);
+                stack.push(symbol.is_number() ? machineState_.get_number_value(symbol) :
+                           symbol.is_device() ? machineState_.get_device_info(symbol, 2) : 0);
+                break;
+            }
+            case OP_STR:
+                stack.push(0, Bytecode::read_str(pc));
+                break;
+            case OP_UNARY: {
+                TokenType operation = (TokenType)*pc++;
+                stack.push(evaluate_unary(operation, stack.pop().value));
+                break;
+            }
+            case OP_BINARY: {
+                TokenType operation = (TokenType)*pc++;
+                int rhs = stack.pop().value;
+                int lhs = stack.pop().value;
+                stack.push(evaluate_binary(operation, lhs, rhs));
+                break;
+            }
+            case OP_PRINT:
+                for (int i = 0; i < stack.size(); ++i) {
+                    if (stack[i].str != nullptr) {
+                        Serial.print(stack[i].str);
+                    }
+                    else {
+                        Serial.print(stack[i].value);
+                    }
+                }
+                Serial.println("");
+                break;
+            case OP_PRINT_STR:
+                Serial.println(Bytecode::read_str(pc));
+                break;
+            case OP_WAIT:
+                delay(stack.pop().value);
+                break;
+            case OP_PRINT_INFO: {
+                Symbol symbol = lookup(pc, name);
+                print_info(symbol, name);
+                break;
+            }
+            case OP_CREATE_NUM: {
+                Symbol symbol = lookup(pc, name);
+                create_number(name, symbol, stack.pop().value);
+                break;
+            }
+            case OP_CREATE_LED: {
+                Symbol symbol = lookup(pc, name);
+                int brightness = stack.pop().value;
+                create_led(name, symbol, stack.pop().value, brightness);
+                break;
+            }
+            // Creating a group can move the code of the groups, so nothing more is read
+            case OP_CREATE_GROUP:
+                create_group(PoolString(*getPoolFunc_, Bytecode::read_str(pc)), blockEnd);
+                return;
+            case OP_RUN_GROUP: {
+                Symbol symbol = lookup(pc, name);
+                run_group(symbol, name, stack.pop().value);
+                break;
+            }
+            case OP_MOVE_BY:
+            case OP_MOVE_BY_FOR:
+            case OP_SET_TO:
+            case OP_SET_TO_FOR: {
+                Symbol symbol = lookup(pc, name);
+                bool isFor = op == OP_MOVE_BY_FOR || op == OP_SET_TO_FOR;
+                int durationMs = isFor ? stack.pop().value : 0;
+                int value = stack.pop().value;
+                if (op == OP_MOVE_BY || op == OP_MOVE_BY_FOR) {
+                    move_by(symbol, name, value, isFor, durationMs);
+                }
+                else {
+                    set_to(symbol, name, value, isFor, durationMs);
+                }
+                break;
+            }
+            case OP_IF:
+                create_if(stack.pop().value, blockEnd);
+                break;
+            case OP_ELSE:
+                create_else(blockEnd);
+                break;
+            case OP_NOP:
+                break;
+            case OP_BLOCK:
+                blockEnd = Bytecode::read_int(pc);
+                break;
+            default:
+                KTY_LOG_ERROR(F("%s: unknown op code %d\n"), PRINT_FUNC, op);
+                return;
+            }
+        }
+    }
+
+    /*!
+        @brief  Looks up what a name operand of compiled code refers to,
+                using the binding of the operand if it is current,
+                and binding the name again in place if it is not.
+
+        @param  pc
+                Where the operand starts, which is moved past it.
+
+        @param  name
+                Set to the characters of the name.
+
+        @return The handle for the name.
+    */
+    Symbol lookup(unsigned char *& pc, char const *& name) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        unsigned char * bindingPos = pc;
+        SymbolBinding binding = Bytecode::read_binding(pc);
+        pc += sizeof(SymbolBinding);
+        name = Bytecode::read_str(pc);
+        if (!machineState_.is_current(binding)) {
+            binding = machineState_.bind(PoolString(*getPoolFunc_, name));
+            Bytecode::write_binding(bindingPos, binding);
+        }
+        return machineState_.lookup(binding);
+    }
+
+    /*!
+        @brief  Checks if a command opens a new block, by ending in a '('.
+                The characters are scanned from the start, without
+                tokenizing the command, skipping any inside quotes.
+
+        @param  command
+                The command.
+
+        @return True if the command ends in a '(', false otherwise.
+    */
+    bool opens_block(PoolString const & command) const {
+        char last = '\0';
+        // The quote that started the string being scanned, if any
+        char quote = '\0';
+        for (char const * c = command.c_str(); *c != '\0'; ++c) {
+            if (quote == '\0' && (*c == '"' || *c == '\'')) {
+                quote = *c;
+            }
+            else if (*c == quote) {
+                quote = '\0';
+            }
+            if (quote == '\0' && !isspace(*c)) {
+                last = *c;
+            }
+        }
+        return last == '(';
+    }
+
+    /*!
+        @brief  Checks if a command closes a block, by being a single ')'.
+
+        @param  command
+                The command.
+
+        @return True if the command is a single ')', false otherwise.
+    */
+    bool closes_block(PoolString const & command) const {
+        int numParens = 0;
+        for (char const * c = command.c_str(); *c != '\0'; ++c) {
+            if (*c == ')') {
+                ++numParens;
+            }
+            else if (!isspace(*c)) {
+                return false;
+            }
+        }
+        return numParens == 1;
+    }
+
 private:
+    /*!
+        @brief  A running group, or if or else block, whose commands are read
+                in place from the machine state one at a time.
+    */
+    struct Frame {
+        /** The handle of the group holding the commands */
+        Symbol group;
+        /** The index of the first command to run */
+        int begin = 0;
+        /** The index of the next command to run */
+        int pc = 0;
+        /** The index after the last command to run */
+        int end = 0;
+        /** The number of times to run the commands after this time, or -1 to run them forever */
+        int timesLeft = 0;
+        /** The scope level to return to when the frame is done */
+        int scopeLevel = 0;
+        /** The number of commands in the command queue that run after the frame */
+        int queueSize = 0;
+    };
+
     GetAllocFunc * getAllocFunc_;
     GetPoolFunc * getPoolFunc_;
 
     Deque<PoolString> commandQueue_;
     Deque<PoolString> commandBuffer_;
-
-    MachineState<> machineState_;
-    PoolString     lastGroupName_;
+    /** The running frames, innermost last */
+    RingDeque<Frame, Sizes::max_frame_depth> frames_;
+    /** Whether the command being executed was read from a frame */
+    bool fromFrame_ = false;
+    /** Whether a frame of a group that was redefined while it ran has stopped running it */
+    bool releasePending_ = false;
+    /** Whether the block being collected is read from a frame */
+    bool blockFromFrame_ = false;
+    /** The index of the first command of the block being collected, within the group of the frame */
+    int blockBegin_ = 0;
+    /** The index of the command that opens each block inside the group being created,
+        by how deep the block is */
+    int openBlocks_[Sizes::max_scope_depth];
+
+    MachineState<>  machineState_;
+    PoolString      lastGroupName_;
 
     InterpreterStatus status_;
 
     /** Used to check for else/elseif blocks */
-    int        currScopeLevel_ = 0;
-    Deque<int> lastCondition_;
+    int                                        currScopeLevel_ = 0;
+    RingDeque<int, Sizes::max_scope_depth + 1> lastCondition_;
 
     int bracketParity_;
 
     Parser<>    parser_;
     Tokenizer<> tokenizer_;
+    /** Compiles the commands of groups */
+    Compiler<Token, PoolString> compiler_;
 
 };
 
@@ -0,0 +1,61 @@
+#pragma once
+
+/*!
+    Compile-time log levels, numbered the same way as the ArduinoLog levels.
+    Logging calls above KTY_LOG_LEVEL are removed by the preprocessor,
+    so they cost nothing at run time, not even the level check done by Log.
+    Define KTY_LOG_LEVEL before including any kty header to choose the level.
+    By default, Arduino and NDEBUG builds keep warnings and above,
+    and other desktop builds keep everything.
+*/
+#define KTY_LOG_LEVEL_SILENT  0
+#define KTY_LOG_LEVEL_FATAL   1
+#define KTY_LOG_LEVEL_ERROR   2
+#define KTY_LOG_LEVEL_WARNING 3
+#define KTY_LOG_LEVEL_NOTICE  4
+#define KTY_LOG_LEVEL_TRACE   5
+#define KTY_LOG_LEVEL_VERBOSE 6
+
+#if !defined(KTY_LOG_LEVEL)
+#if defined(ARDUINO) || defined(NDEBUG)
+#define KTY_LOG_LEVEL KTY_LOG_LEVEL_WARNING
+#else
+#define KTY_LOG_LEVEL KTY_LOG_LEVEL_VERBOSE
+#endif
+#endif
+
+#if KTY_LOG_LEVEL >= KTY_LOG_LEVEL_FATAL
+#define KTY_LOG_FATAL(...) Log.fatal(__VA_ARGS__)
+#else
+#define KTY_LOG_FATAL(...) do {} while (0)
+#endif
+
+#if KTY_LOG_LEVEL >= KTY_LOG_LEVEL_ERROR
+#define KTY_LOG_ERROR(...) Log.error(__VA_ARGS__)
+#else
+#define KTY_LOG_ERROR(...) do {} while (0)
+#endif
+
+#if KTY_LOG_LEVEL >= KTY_LOG_LEVEL_WARNING
+#define KTY_LOG_WARNING(...) Log.warning(__VA_ARGS__)
+#else
+#define KTY_LOG_WARNING(...) do {} while (0)
+#endif
+
+#if KTY_LOG_LEVEL >= KTY_LOG_LEVEL_NOTICE
+#define KTY_LOG_NOTICE(...) Log.notice(__VA_ARGS__)
+#else
+#define KTY_LOG_NOTICE(...) do {} while (0)
+#endif
+
+#if KTY_LOG_LEVEL >= KTY_LOG_LEVEL_TRACE
+#define KTY_LOG_TRACE(...) Log.trace(__VA_ARGS__)
+#else
+#define KTY_LOG_TRACE(...) do {} while (0)
+#endif
+
+#if KTY_LOG_LEVEL >= KTY_LOG_LEVEL_VERBOSE
+#define KTY_LOG_VERBOSE(...) Log.verbose(__VA_ARGS__)
+#else
+#define KTY_LOG_VERBOSE(...) do {} while (0)
+#endif
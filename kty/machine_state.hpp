@@ -3,8 +3,12 @@
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/deque.hpp>
 #include <kty/containers/deque_of_deque.hpp>
+#include <kty/containers/ring_deque.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/containers/symbol_table.hpp>
+#include <kty/log.hpp>
+#include <kty/sizes.hpp>
 #include <kty/types.hpp>
 
 namespace kty {
@@ -15,10 +19,108 @@ enum DeviceType {
     UNKNOWN_DEVICE,
 };
 
+/** The kinds of thing a name can refer to */
+enum SymbolKind {
+    NO_SYMBOL,
+    NUMBER_SYMBOL,
+    DEVICE_SYMBOL,
+    GROUP_SYMBOL,
+};
+
+/*!
+    @brief  Handle to a name held by the machine state.
+            Names are shared between numbers, devices and groups, so a name
+            is looked up once, and then read or written through its handle.
+            Handles stay valid until the machine state is reset.
+*/
+class Symbol {
+
+public:
+    /*!
+        @brief  Constructor for a handle to nothing.
+    */
+    Symbol() {
+    }
+
+    /*!
+        @brief  Constructor for a handle.
+
+        @param  kind
+                What the name refers to.
+
+        @param  slot
+                Where the thing is stored among things of its kind.
+    */
+    Symbol(SymbolKind const & kind, int const & slot)
+        : kind_(kind), slot_(slot) {
+    }
+
+    /*!
+        @brief  Gets what the name refers to.
+
+        @return The kind of the symbol.
+    */
+    SymbolKind kind() const {
+        return kind_;
+    }
+
+    /*!
+        @brief  Gets where the thing is stored among things of its kind.
+
+        @return The slot of the symbol, or -1 if the name refers to nothing.
+    */
+    int slot() const {
+        return slot_;
+    }
+
+    /*!
+        @brief  Checks if the name refers to anything.
+
+        @return True if the name exists, false otherwise.
+    */
+    bool exists() const {
+        return kind_ != NO_SYMBOL;
+    }
+
+    /*!
+        @brief  Checks if the name refers to a number.
+
+        @return True if the name is a number, false otherwise.
+    */
+    bool is_number() const {
+        return kind_ == NUMBER_SYMBOL;
+    }
+
+    /*!
+        @brief  Checks if the name refers to a device.
+
+        @return True if the name is a device, false otherwise.
+    */
+    bool is_device() const {
+        return kind_ == DEVICE_SYMBOL;
+    }
+
+    /*!
+        @brief  Checks if the name refers to a group.
+
+        @return True if the name is a group, false otherwise.
+    */
+    bool is_group() const {
+        return kind_ == GROUP_SYMBOL;
+    }
+
+private:
+    SymbolKind kind_ = NO_SYMBOL;
+    int slot_ = -1;
+
+};
+
 /*!
     @brief  Class that contains information about the current machine state.
             Information stored includes device names and information,
             and group names and information.
+            Numbers, devices and groups share one namespace, held in a
+            symbol table that maps each name to a Symbol handle.
 */
 template <typename GetAllocFunc = decltype(get_alloc), typename GetPoolFunc = decltype(get_stringpool), typename PoolString = PoolString<>>
 class MachineState {
@@ -35,24 +137,81 @@ public:
     */
     MachineState(GetAllocFunc & getAllocFunc = get_alloc, GetPoolFunc & getPoolFunc = get_stringpool)
         : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc),
-          deviceNames_(getAllocFunc), deviceTypes_(getAllocFunc), 
-          deviceInfo_0_(getAllocFunc), deviceInfo_1_(getAllocFunc), deviceInfo_2_(getAllocFunc),
-          groupNames_(getAllocFunc), groupCommands_(getAllocFunc, getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+          groupCommands_(getAllocFunc, getPoolFunc) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        clear_group_slots();
     }
 
     /*!
         @brief  Resets the state, clearing all memory.
+                Any handles given out before are no longer valid.
     */
     void reset() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        deviceNames_.clear();
-        deviceTypes_.clear();
-        deviceInfo_0_.clear();
-        deviceInfo_1_.clear();
-        deviceInfo_2_.clear();
-        groupNames_.clear();
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        symbols_.clear();
+        numbers_.clear();
+        devices_.clear();
         groupCommands_.clear();
+        buildingGroup_ = false;
+        clear_group_slots();
+    }
+
+    /*!
+        @brief  Looks up what a name refers to.
+
+        @param  name
+                The name to look up.
+
+        @return The handle for the name.
+                If the name does not exist, the handle refers to nothing.
+    */
+    Symbol lookup(PoolString const & name) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol const * symbol = symbols_.find(name);
+        return symbol == nullptr ? Symbol() : *symbol;
+    }
+
+    /*!
+        @brief  Binds a name ahead of time, so that it can be looked up
+                again without searching, until the name is defined or the
+                state is reset.
+
+        @param  name
+                The name to bind.
+
+        @return The binding for the name.
+    */
+    SymbolBinding bind(PoolString const & name) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return symbols_.bind(name);
+    }
+
+    /*!
+        @brief  Checks if a binding can still be used in place of its name.
+
+        @param  binding
+                The binding made by bind().
+
+        @return True if the binding is current, false if the name must be bound again.
+    */
+    bool is_current(SymbolBinding const & binding) const {
+        return symbols_.is_current(binding);
+    }
+
+    /*!
+        @brief  Looks up what a bound name refers to, without searching.
+
+        @param  binding
+                A current binding made by bind().
+
+        @return The handle for the name.
+                If the name did not exist when bound, or the binding is not
+                current, the handle refers to nothing.
+    */
+    Symbol lookup(SymbolBinding const & binding) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol const * symbol = symbols_.find(binding);
+        return symbol == nullptr ? Symbol() : *symbol;
     }
 
     /*!
@@ -64,13 +223,8 @@ public:
         @return True if the number exists, false otherwise.
     */
     bool number_exists(PoolString const & name) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        for (typename Deque<PoolString>::ConstIterator it = numberNames_.cbegin(); it != numberNames_.cend(); ++it) {
-            if (*it == name) {
-                 return true;
-            }
-        }
-        return false;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return lookup(name).is_number();
     }
 
     /*!
@@ -83,19 +237,26 @@ public:
                 Otherwise 0 is returned.
     */
     int get_number_value(PoolString const & name) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        typename Deque<PoolString>::ConstIterator nameIter = numberNames_.cbegin();
-        typename Deque<int>::ConstIterator valueIter = numberValues_.cbegin();
-        for ( ; nameIter != numberNames_.cend() && valueIter != numberValues_.cend(); ++nameIter, ++valueIter) {
-            if (*nameIter == name) {
-                return *valueIter;
-            }
-        }
-        return 0;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return get_number_value(lookup(name));
     }
 
     /*!
-        @brief  Sets the number.
+        @brief  Gets the value of a number.
+
+        @param  symbol
+                The handle of the number.
+        
+        @return The number value, if the handle is for a number.
+                Otherwise 0 is returned.
+    */
+    int get_number_value(Symbol const & symbol) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return symbol.is_number() ? numbers_[symbol.slot()] : 0;
+    }
+
+    /*!
+        @brief  Sets the number, creating it if the name does not exist.
 
         @param  name
                 The name of the number.
@@ -106,19 +267,37 @@ public:
         @return True if the set was successful, false otherwise.
     */
     bool set_number(PoolString const & name, int const & value) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        typename Deque<PoolString>::Iterator nameIter = numberNames_.begin();
-        typename Deque<int>::Iterator valueIter = numberValues_.begin();
-        for ( ; nameIter != numberNames_.end() && valueIter != numberValues_.end(); ++nameIter, ++valueIter) {
-            if (*nameIter == name) {
-                *valueIter = value;
-                return true;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol symbol = lookup(name);
+        if (!symbol.exists()) {
+            if (numbers_.is_full() || !add_symbol(name, Symbol(NUMBER_SYMBOL, numbers_.size()))) {
+                return false;
             }
+            numbers_.push_back(value);
+            return true;
         }
-        bool result = true;
-        result = numberNames_.push_front(name) && result;
-        result = numberValues_.push_front(value) && result;
-        return result;
+        return set_number(symbol, value);
+    }
+
+    /*!
+        @brief  Sets the number.
+
+        @param  symbol
+                The handle of the number.
+        
+        @param  value
+                The value of the number.
+
+        @return True if the set was successful, false if the handle is not for a number.
+    */
+    bool set_number(Symbol const & symbol, int const & value) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_number()) {
+            KTY_LOG_WARNING(F("%s: name is not a number\n"), PRINT_FUNC);
+            return false;
+        }
+        numbers_[symbol.slot()] = value;
+        return true;
     }
 
     /*!
@@ -130,13 +309,8 @@ public:
         @return True if the device exists, false otherwise.
     */
     bool device_exists(PoolString const & name) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        for (typename Deque<PoolString>::ConstIterator it = deviceNames_.cbegin(); it != deviceNames_.cend(); ++it) {
-            if (*it == name) {
-                 return true;
-            }
-        }
-        return false;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return lookup(name).is_device();
     }
 
     /*!
@@ -149,15 +323,22 @@ public:
                 Otherwise the unknown device type is returned.
     */
     DeviceType get_device_type(PoolString const & name) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        typename Deque<PoolString>::ConstIterator nameIter = deviceNames_.cbegin();
-        typename Deque<DeviceType>::ConstIterator typeIter = deviceTypes_.cbegin();
-        for ( ; nameIter != deviceNames_.cend() && typeIter != deviceTypes_.cend(); ++nameIter, ++typeIter) {
-            if (*nameIter == name) {
-                return *typeIter;
-            }
-        }
-        return DeviceType::UNKNOWN_DEVICE;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return get_device_type(lookup(name));
+    }
+
+    /*!
+        @brief  Gets the type of a device.
+
+        @param  symbol
+                The handle of the device.
+        
+        @return The device type, if the handle is for a device.
+                Otherwise the unknown device type is returned.
+    */
+    DeviceType get_device_type(Symbol const & symbol) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return symbol.is_device() ? devices_[symbol.slot()].type : DeviceType::UNKNOWN_DEVICE;
     }
 
     /*!
@@ -173,32 +354,32 @@ public:
                 Otherwise -1 is returned.
     */
     int get_device_info(PoolString const & name, int const & idx) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        typename Deque<PoolString>::ConstIterator nameIter = deviceNames_.cbegin();
-        typename Deque<int>::ConstIterator info0Iter = deviceInfo_0_.cbegin();
-        typename Deque<int>::ConstIterator info1Iter = deviceInfo_1_.cbegin();
-        typename Deque<int>::ConstIterator info2Iter = deviceInfo_2_.cbegin();
-        for ( ; nameIter != deviceNames_.cend() && 
-                info0Iter != deviceInfo_0_.cend() &&
-                info1Iter != deviceInfo_1_.cend() &&
-                info2Iter != deviceInfo_2_.cend(); ++nameIter, ++info0Iter,  ++info1Iter, ++info2Iter) {
-            if (*nameIter == name) {
-                switch (idx) {
-                case 0:
-                    return *info0Iter;
-                case 1:
-                    return *info1Iter;
-                case 2:
-                    return *info2Iter;
-                };
-                return -1;
-            }
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return get_device_info(lookup(name), idx);
+    }
+
+    /*!
+        @brief  Gets the info of a device.
+
+        @param  symbol
+                The handle of the device.
+
+        @param  idx
+                The information index.
+        
+        @return The device info, if the handle is for a device.
+                Otherwise -1 is returned.
+    */
+    int get_device_info(Symbol const & symbol, int const & idx) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_device() || idx < 0 || idx >= Device::num_info) {
+            return -1;
         }
-        return -1;
+        return devices_[symbol.slot()].info[idx];
     }
 
     /*!
-        @brief  Sets the device.
+        @brief  Sets the device, creating it if the name does not exist.
 
         @param  name
                 The name of the device.
@@ -218,32 +399,50 @@ public:
         @return True if the set was successful, false otherwise.
     */
     bool set_device(PoolString const & name, DeviceType type, int const & info0, int const & info1, int const & info2) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        typename Deque<PoolString>::Iterator nameIter = deviceNames_.begin();
-        typename Deque<DeviceType>::Iterator typeIter = deviceTypes_.begin();
-        typename Deque<int>::Iterator info0Iter = deviceInfo_0_.begin();
-        typename Deque<int>::Iterator info1Iter = deviceInfo_1_.begin();
-        typename Deque<int>::Iterator info2Iter = deviceInfo_2_.begin();
-        for ( ; nameIter != deviceNames_.end() && 
-                typeIter != deviceTypes_.end() &&
-                info0Iter != deviceInfo_0_.end() &&
-                info1Iter != deviceInfo_1_.end() &&
-                info2Iter != deviceInfo_2_.end(); ++nameIter, ++typeIter, ++info0Iter, ++info1Iter, ++info2Iter) {
-            if (*nameIter == name) {
-                *typeIter = type;
-                *info0Iter = info0;
-                *info1Iter = info1;
-                *info2Iter = info2;
-                return true;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Symbol symbol = lookup(name);
+        if (!symbol.exists()) {
+            symbol = Symbol(DEVICE_SYMBOL, devices_.size());
+            if (devices_.is_full() || !add_symbol(name, symbol)) {
+                return false;
             }
+            devices_.push_back(Device());
         }
-        bool result = true;
-        result = deviceNames_.push_front(name) && result;
-        result = deviceTypes_.push_front(type) && result;
-        result = deviceInfo_0_.push_front(info0) && result;
-        result = deviceInfo_1_.push_front(info1) && result;
-        result = deviceInfo_2_.push_front(info2) && result;
-        return result;
+        return set_device(symbol, type, info0, info1, info2);
+    }
+
+    /*!
+        @brief  Sets the device.
+
+        @param  symbol
+                The handle of the device.
+
+        @param  type
+                The type of the device.
+
+        @param  info0
+                The info 0 of the device.
+        
+        @param  info1
+                The info 1 of the device.
+
+        @param  info2
+                The info 2 of the device.
+        
+        @return True if the set was successful, false if the handle is not for a device.
+    */
+    bool set_device(Symbol const & symbol, DeviceType type, int const & info0, int const & info1, int const & info2) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_device()) {
+            KTY_LOG_WARNING(F("%s: name is not a device\n"), PRINT_FUNC);
+            return false;
+        }
+        Device & device = devices_[symbol.slot()];
+        device.type = type;
+        device.info[0] = info0;
+        device.info[1] = info1;
+        device.info[2] = info2;
+        return true;
     }
 
     /*!
@@ -255,13 +454,8 @@ public:
         @return True if the group exists, false otherwise.
     */
     bool group_exists(PoolString const & name) const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        for (typename Deque<PoolString>::ConstIterator it = groupNames_.cbegin(); it != groupNames_.cend(); ++it) {
-            if (*it == name) {
-                 return true;
-            }
-        }
-        return false;
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return lookup(name).is_group();
     }
 
     /*!
@@ -274,20 +468,300 @@ public:
                 If the group does not exist, an empty deque is returned.
     */
     Deque<PoolString> get_group_commands(PoolString const & name) const {
-        Deque<PoolString> commands;
-        int i = 0;
-        for (typename Deque<PoolString>::ConstIterator it = groupNames_.cbegin(); it != groupNames_.cend(); ++it, ++i) {
-            if (*it == name) {
-                for (int j = 0; j < groupCommands_.size(i); ++j) {
-                    commands.push_back(groupCommands_.get_str(i, j));
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return get_group_commands(lookup(name));
+    }
+
+    /*!
+        @brief  Gets the commands within a group.
+
+        @param  symbol
+                The handle of the group.
+
+        @return The commands within the group.
+                If the handle is not for a group, an empty deque is returned.
+    */
+    Deque<PoolString> get_group_commands(Symbol const & symbol) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // Allocate with the state's allocator, so the commands can be spliced elsewhere
+        Deque<PoolString> commands(*getAllocFunc_);
+        if (!symbol.is_group()) {
+            return commands;
+        }
+        for (int j = 0; j < groupCommands_.size(symbol.slot()); ++j) {
+            commands.push_back(groupCommands_.get_str(symbol.slot(), j));
+        }
+        return commands;
+    }
+
+    /*!
+        @brief  Gets the number of commands within a group.
+
+        @param  symbol
+                The handle of the group.
+
+        @return The number of commands within the group.
+                If the handle is not for a group, -1 is returned.
+    */
+    int get_group_size(Symbol const & symbol) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group()) {
+            return -1;
+        }
+        return groupCommands_.size(symbol.slot());
+    }
+
+    /*!
+        @brief  Gets one command within a group, without copying the others.
+
+        @param  symbol
+                The handle of the group.
+
+        @param  j
+                The index of the command within the group.
+
+        @return The command, which shares the index of the stored command
+                in the string pool, so nothing is allocated.
+                If the handle is not for a group or j is invalid, an empty string is returned.
+    */
+    PoolString get_group_command(Symbol const & symbol, int const & j) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group()) {
+            return PoolString(*getPoolFunc_);
+        }
+        return groupCommands_.get_str(symbol.slot(), j);
+    }
+
+    /*!
+        @brief  Sets the compiled code of one command within a group.
+
+        @param  symbol
+                The handle of the group.
+
+        @param  j
+                The index of the command within the group.
+
+        @param  code
+                The bytes of the code.
+
+        @param  len
+                The number of bytes of the code.
+
+        @return True if successful, false if the handle is not for a group,
+                j is invalid or there is no space for the code.
+    */
+    bool set_group_code(Symbol const & symbol, int const & j, unsigned char const * code, int const & len) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group()) {
+            return false;
+        }
+        return groupCommands_.set_code(symbol.slot(), j, code, len);
+    }
+
+    /*!
+        @brief  Gets the compiled code of one command within a group.
+
+        @param  symbol
+                The handle of the group.
+
+        @param  j
+                The index of the command within the group.
+
+        @return A pointer to the code, which stays valid until a group is set.
+                nullptr is returned if the command has no code,
+                the handle is not for a group or j is invalid.
+    */
+    unsigned char * get_group_code(Symbol const & symbol, int const & j) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group()) {
+            return nullptr;
+        }
+        return groupCommands_.get_code(symbol.slot(), j);
+    }
+
+    /*!
+        @brief  Starts building the commands of a new group,
+                which only takes the place of a group once it is finished
+                by set_new_group(), so that a group being run is not changed
+                while its new commands are added.
+                Any new group that was not finished is dropped.
+
+        @return True if successful, false if there is no space for another group.
+    */
+    bool begin_new_group() {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        drop_new_group();
+        if (!groupCommands_.push_back()) {
+            return false;
+        }
+        buildingGroup_ = true;
+        return true;
+    }
+
+    /*!
+        @brief  Adds a command to the new group.
+
+        @param  command
+                The command.
+
+        @param  code
+                The compiled code of the command, or nullptr if it has none.
+
+        @param  len
+                The number of bytes of the code.
+
+        @return The index of the command within the new group,
+                or -1 if no new group is being built or there is no space.
+    */
+    int add_to_new_group(PoolString const & command, unsigned char const * code = nullptr, int const & len = 0) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        int i = groupCommands_.size() - 1;
+        if (!buildingGroup_ || !groupCommands_.push_back(i, command)) {
+            return -1;
+        }
+        int j = groupCommands_.size(i) - 1;
+        if (code != nullptr) {
+            groupCommands_.set_code(i, j, code, len);
+        }
+        return j;
+    }
+
+    /*!
+        @brief  Copies a command of a group, with its compiled code, to the new group.
+
+        @param  symbol
+                The handle of the group.
+
+        @param  j
+                The index of the command within the group.
+
+        @return The index of the command within the new group,
+                or -1 if no new group is being built, the command does not exist
+                or there is no space.
+    */
+    int copy_to_new_group(Symbol const & symbol, int const & j) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group() || j < 0 || j >= groupCommands_.size(symbol.slot())) {
+            return -1;
+        }
+        // The code of the new group comes after the code of every other group,
+        // so adding to it does not move the code being copied
+        return add_to_new_group(groupCommands_.get_str(symbol.slot(), j),
+                                groupCommands_.get_code(symbol.slot(), j),
+                                groupCommands_.get_code_size(symbol.slot(), j));
+    }
+
+    /*!
+        @brief  Gets the compiled code of one command within the new group.
+
+        @param  j
+                The index of the command within the new group.
+
+        @return A pointer to the code, or nullptr if the command has no code
+                or no new group is being built.
+    */
+    unsigned char * get_new_group_code(int const & j) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!buildingGroup_) {
+            return nullptr;
+        }
+        return groupCommands_.get_code(groupCommands_.size() - 1, j);
+    }
+
+    /*!
+        @brief  Finishes the new group, giving it a name.
+                The group of the name is set to the commands of the new group,
+                and is created if the name does not exist.
+                The commands of a group that is still running are kept, in
+                their own slot, until release_group() is called for them.
+
+        @param  name
+                The name of the group.
+
+        @param  keepOld
+                Whether to keep the old commands of the group, because they
+                are still running.
+
+        @return True if successful, false otherwise, in which case
+                the new group is dropped.
+    */
+    bool set_new_group(PoolString const & name, bool const & keepOld = false) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!buildingGroup_) {
+            return false;
+        }
+        Symbol symbol = lookup(name);
+        if (symbol.exists() && !symbol.is_group()) {
+            KTY_LOG_WARNING(F("%s: %s is not a group\n"), PRINT_FUNC, name.c_str());
+            drop_new_group();
+            return false;
+        }
+        int slot = symbol.is_group() && !keepOld ? symbol.slot() : free_group_slot();
+        // Names are only added once there is space for the commands, so that both stay in step
+        if ((!symbol.exists() && symbols_.is_full()) || (slot == -1 && groupCommands_.size() > Sizes::max_num_groups)) {
+            KTY_LOG_WARNING(F("%s: no space for group %s\n"), PRINT_FUNC, name.c_str());
+            drop_new_group();
+            return false;
+        }
+        if (slot == -1) {
+            slot = groupCommands_.size() - 1;
+        }
+        else {
+            groupCommands_.replace(slot);
+            freeGroupSlots_[slot] = false;
+        }
+        if (symbol.is_group() && slot != symbol.slot()) {
+            // Whatever was replaced by the old commands is now replaced by the new ones
+            for (int i = 0; i < Sizes::max_num_groups + 1; ++i) {
+                if (replacedBy_[i] == symbol.slot()) {
+                    replacedBy_[i] = slot;
                 }
             }
+            replacedBy_[symbol.slot()] = slot;
         }
-        return commands;
+        symbols_.insert(name, Symbol(GROUP_SYMBOL, slot));
+        buildingGroup_ = false;
+        return true;
+    }
+
+    /*!
+        @brief  Gets the group that replaced a group while it was running.
+
+        @param  symbol
+                The handle of the group.
+
+        @return The handle of the group of the same name, which is the
+                given handle if the group was not replaced while running.
+    */
+    Symbol get_current_group(Symbol const & symbol) const {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group() || replacedBy_[symbol.slot()] == -1) {
+            return symbol;
+        }
+        return Symbol(GROUP_SYMBOL, replacedBy_[symbol.slot()]);
+    }
+
+    /*!
+        @brief  Releases the old commands of a group that was replaced while
+                running, once they are no longer run, so that their slot
+                can hold another group.
+                Does nothing for a group that was not replaced.
+
+        @param  symbol
+                The handle of the old commands of the group.
+    */
+    void release_group(Symbol const & symbol) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!symbol.is_group() || replacedBy_[symbol.slot()] == -1) {
+            return;
+        }
+        groupCommands_.clear(symbol.slot());
+        replacedBy_[symbol.slot()] = -1;
+        freeGroupSlots_[symbol.slot()] = true;
     }
 
     /*!
-        @brief  Sets a group.
+        @brief  Sets a group, creating it if the name does not exist.
 
         @param  name
                 The name of the group.
@@ -298,39 +772,96 @@ public:
         @return True if the set was successful, false otherwise.
     */
     bool set_group(PoolString const & name, Deque<PoolString> const & commands) {
-        int i = 0;
-        bool result = true;
-        for (typename Deque<PoolString>::Iterator it = groupNames_.begin(); it != groupNames_.end(); ++it, ++i) {
-            if (*it == name) {
-                groupCommands_.clear(i);
-                for (typename Deque<PoolString>::ConstIterator cmdIt = commands.begin(); cmdIt != commands.end(); ++cmdIt) {
-                    result = groupCommands_.push_back(i, *cmdIt) && result;
-                }
-                return result;
-            }
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        if (!begin_new_group()) {
+            return false;
         }
-        result = groupNames_.push_front(name) && result;
-        groupCommands_.push_front();
+        bool result = true;
         for (typename Deque<PoolString>::ConstIterator cmdIt = commands.begin(); cmdIt != commands.end(); ++cmdIt) {
-            result = groupCommands_.push_back(0, *cmdIt) && result;
+            result = add_to_new_group(*cmdIt) != -1 && result;
         }
-        return result;
+        return set_new_group(name) && result;
     }
 
 private:
+    /*!
+        @brief  Finds a slot released by release_group().
+
+        @return The slot, or -1 if there is none.
+    */
+    int free_group_slot() const {
+        for (int i = 0; i < groupCommands_.size() - 1; ++i) {
+            if (freeGroupSlots_[i]) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /*!
+        @brief  Marks every group slot as holding the commands of its own name.
+    */
+    void clear_group_slots() {
+        for (int i = 0; i < Sizes::max_num_groups + 1; ++i) {
+            replacedBy_[i] = -1;
+            freeGroupSlots_[i] = false;
+        }
+    }
+
+    /*!
+        @brief  Drops the new group, if one is being built.
+    */
+    void drop_new_group() {
+        if (buildingGroup_) {
+            groupCommands_.pop_back();
+            buildingGroup_ = false;
+        }
+    }
+
+    /*!
+        @brief  The type and information of a device.
+    */
+    struct Device {
+        /** The number of information values of a device */
+        static const int num_info = 3;
+
+        DeviceType type = DeviceType::UNKNOWN_DEVICE;
+        int info[num_info] = {-1, -1, -1};
+    };
+
+    /*!
+        @brief  Adds a new name to the symbol table.
+
+        @param  name
+                The name, which must not exist yet.
+
+        @param  symbol
+                The handle for the name.
+
+        @return True if the name was added, false if the symbol table is full.
+    */
+    bool add_symbol(PoolString const & name, Symbol const & symbol) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        return symbols_.insert(name, symbol) != nullptr;
+    }
+
     GetAllocFunc * getAllocFunc_;
     GetPoolFunc * getPoolFunc_;
 
-    Deque<PoolString> numberNames_;
-    Deque<int>        numberValues_;
-    Deque<PoolString> deviceNames_;
-    Deque<DeviceType> deviceTypes_;
-    Deque<int>        deviceInfo_0_;
-    Deque<int>        deviceInfo_1_;
-    Deque<int>        deviceInfo_2_;
-
-    Deque<PoolString>      groupNames_;
-    DequeDequePoolString<> groupCommands_;
+    /** The handle of each name */
+    SymbolTable<Symbol, Sizes::max_num_symbols, PoolString> symbols_;
+    /** The value of each number, indexed by slot */
+    RingDeque<int, Sizes::max_num_numbers>                  numbers_;
+    /** The type and information of each device, indexed by slot */
+    RingDeque<Device, Sizes::max_num_devices>               devices_;
+    /** The commands of each group, indexed by slot, followed by those of the new group */
+    DequeDequePoolString<GetAllocFunc, GetPoolFunc, StringPool<Sizes::stringpool_size, Sizes::string_length>, Sizes::max_num_groups + 1> groupCommands_;
+    /** Whether a new group is being built in the last deque of groupCommands_ */
+    bool                                                    buildingGroup_ = false;
+    /** For each group slot, the slot of the group that replaced it while it was running, or -1 */
+    int                                                     replacedBy_[Sizes::max_num_groups + 1];
+    /** For each group slot, whether it was released and can hold another group */
+    bool                                                    freeGroupSlots_[Sizes::max_num_groups + 1];
 
 };
 
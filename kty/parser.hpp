@@ -4,6 +4,7 @@
 #include <kty/containers/deque.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/token.hpp>
 #include <kty/tokenizer.hpp>
 #include <kty/string_utils.hpp>
@@ -29,7 +30,7 @@ public:
     */
     Parser(GetAllocFunc & getAllocFunc = get_alloc, GetPoolFunc & getPoolFunc = get_stringpool)
         : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc), command_(getAllocFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     }
     
     /*!
@@ -46,7 +47,7 @@ public:
     */
     Parser(GetAllocFunc & getAllocFunc, GetPoolFunc & getPoolFunc, Deque<Token> const & command)
         : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc), command_(getAllocFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         set_command(command);
     }
 
@@ -57,18 +58,31 @@ public:
                 The tokenized command to parse.
     */
     void set_command(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         command_ = command;
         preprocess();
     }
 
+    /*!
+        @brief  Sets the command for the parser to parse.
+                The tokens are moved into the parser instead of being copied.
+
+        @param  command
+                The tokenized command to parse.
+    */
+    void set_command(Deque<Token> && command) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        command_ = move(command);
+        preprocess();
+    }
+
     /*!
         @brief  Parses the command stored in the parser.
 
         @return The parsed command tokens.
     */
     Deque<Token> parse() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         return run_shunting_yard();        
     }
 
@@ -81,16 +95,31 @@ public:
         @return The parsed command tokens.
     */
     Deque<Token> parse(Deque<Token> const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         set_command(command);
         return parse();
     }
 
+    /*!
+        @brief  Parses the given command.
+                The tokens are moved into the parser instead of being copied.
+
+        @param  command
+                The tokenized command to parse.
+
+        @return The parsed command tokens.
+    */
+    Deque<Token> parse(Deque<Token> && command) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        set_command(move(command));
+        return parse();
+    }
+
     /*!
         @brief  Preprocesses the stored command to prepare for parsing.
     */
     void preprocess() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Erase CMD_END token from the back if it exists
         if (command_.size() > 0 && command_.back().is_cmd_end()) {
             command_.pop_back();
@@ -108,71 +137,72 @@ public:
         @return The converted postfix expression.
     */
     Deque<Token> run_shunting_yard() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Deque<Token> operatorStack(*getAllocFunc_);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        // Operators rarely nest deeply, so the stack mostly stays in its own blocks
+        Deque<Token, SlabAllocator<>, GetAllocFunc, Sizes::small_deque_size> operatorStack(*getAllocFunc_);
         Deque<Token> output(*getAllocFunc_);
 
         for (typename Deque<Token>::Iterator it = command_.begin(); it != command_.end(); ++it) {
             Token & token = *it;
             if (token.is_operand()) {
-                Log.verbose(F("%s: operand\n"), PRINT_FUNC);
-                Log.verbose(F("%s: operand %s pushed to output\n"), PRINT_FUNC, token.str().c_str());
+                KTY_LOG_VERBOSE(F("%s: operand\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: operand %s pushed to output\n"), PRINT_FUNC, token.str().c_str());
                 output.push_back(token);
             }
             else if (token.is_function()) {
-                Log.verbose(F("%s: function\n"), PRINT_FUNC);
-                Log.verbose(F("%s: function %s pushed to operator stack\n"), PRINT_FUNC, token.str().c_str());
+                KTY_LOG_VERBOSE(F("%s: function\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: function %s pushed to operator stack\n"), PRINT_FUNC, token.str().c_str());
                 operatorStack.push_back(token);
             }
             else if (token.is_operator()) {
-                Log.verbose(F("%s: operator\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: operator\n"), PRINT_FUNC);
                 while (!operatorStack.is_empty() &&
                        (operatorStack.back().is_function() ||
                         operatorStack.back().has_greater_precedence_than(token) ||
                            (operatorStack.back().has_equal_precedence_to(token) && 
                             operatorStack.back().is_left_associative())) &&
                        !operatorStack.back().is_op_paren()) {
-                    Log.verbose(F("%s: operator %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
-                    output.push_back(operatorStack.back());
+                    KTY_LOG_VERBOSE(F("%s: operator %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
+                    output.push_back(move(operatorStack.back()));
                     operatorStack.pop_back();                    
                 }
-                Log.verbose(F("%s: operator %s pushed to operator stack\n"), PRINT_FUNC, token.str().c_str());
+                KTY_LOG_VERBOSE(F("%s: operator %s pushed to operator stack\n"), PRINT_FUNC, token.str().c_str());
                 operatorStack.push_back(token);
             }
             else if (token.is_op_paren()) {
-                Log.verbose(F("%s: op_paren\n"), PRINT_FUNC);
-                Log.verbose(F("%s: op paren %s pushed to operator stack\n"), PRINT_FUNC, token.str().c_str());
+                KTY_LOG_VERBOSE(F("%s: op_paren\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: op paren %s pushed to operator stack\n"), PRINT_FUNC, token.str().c_str());
                 operatorStack.push_back(token);
             }
             else if (token.is_cl_paren()) {
-                Log.verbose(F("%s: cl_paren\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: cl_paren\n"), PRINT_FUNC);
                 while (!operatorStack.is_empty() && 
                        !operatorStack.back().is_op_paren()) {
-                    Log.verbose(F("%s: %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
-                    output.push_back(operatorStack.back());
+                    KTY_LOG_VERBOSE(F("%s: %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
+                    output.push_back(move(operatorStack.back()));
                     operatorStack.pop_back();                    
                 }
-                Log.verbose(F("%s: %s popped from operator stack\n"), PRINT_FUNC, operatorStack.back().str().c_str());
+                KTY_LOG_VERBOSE(F("%s: %s popped from operator stack\n"), PRINT_FUNC, operatorStack.back().str().c_str());
                 operatorStack.pop_back();
             }
             else if (token.is_comma()) {
-                Log.verbose(F("%s: comma\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: comma\n"), PRINT_FUNC);
                 while (!operatorStack.is_empty() && 
                        !operatorStack.back().is_op_paren()) {
-                    Log.verbose(F("%s: %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
-                    output.push_back(operatorStack.back());
+                    KTY_LOG_VERBOSE(F("%s: %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
+                    output.push_back(move(operatorStack.back()));
                     operatorStack.pop_back();                    
                 }
             }
             else {
-                Log.verbose(F("%s: others\n"), PRINT_FUNC);
-                Log.verbose(F("%s: %s pushed to output\n"), PRINT_FUNC, token.str().c_str());
+                KTY_LOG_VERBOSE(F("%s: others\n"), PRINT_FUNC);
+                KTY_LOG_VERBOSE(F("%s: %s pushed to output\n"), PRINT_FUNC, token.str().c_str());
                 output.push_back(token);
             }
         }
         while (!operatorStack.is_empty()) {
-            Log.verbose(F("%s: %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
-            output.push_back(operatorStack.back());
+            KTY_LOG_VERBOSE(F("%s: %s pushed from operator stack to output\n"), PRINT_FUNC, operatorStack.back().str().c_str());
+            output.push_back(move(operatorStack.back()));
             operatorStack.pop_back();
         }
         return output;
@@ -9,23 +9,112 @@ class Sizes {
 
 public:
 #if defined(ARDUINO)
+    /* Sized for an Arduino Mega. The allocator, string pool and interpreter
+       take about 5.1KB of its 8KB of RAM, which leaves about 3KB for the
+       stack, the Arduino core and the Serial buffers. */
     /** The number of blocks in the allocator. */
     static const int alloc_size = 128;
     /** The number of bytes that makes up one allocator block. */
     static const int alloc_block_size = sizeof(int) * 6;
+    /** The block sizes of the slab allocator classes, smallest first.
+        They fit the char and int, PoolString and Token deque nodes. */
+    static const int slab_block_size_0 = sizeof(int) * 3;
+    static const int slab_block_size_1 = sizeof(int) * 4;
+    static const int slab_block_size_2 = sizeof(int) * 6;
+    static const int slab_block_size_3 = sizeof(int) * 7;
+    /** The number of blocks in each slab allocator class.
+        A 64 character line takes up to 48 Token nodes, and each line of
+        an if or else block typed at the prompt takes a PoolString node. */
+    static const int slab_size_0 = 8;
+    static const int slab_size_1 = 4;
+    static const int slab_size_2 = 24;
+    static const int slab_size_3 = 48;
     /** The number of strings in the stringpool. */
     static const int stringpool_size = 64;
     /** The maximum number of characters per string. */    
-    static const int string_length = 32;
+    static const int string_length = 64;
+    /** The number of bytes that the characters of all strings are packed into.
+        Names, group commands and the current line take most of it. */
+    static const int stringpool_bytes = 1024;
+    /** The maximum number of characters of a string stored inside a PoolString.
+        One character fits beside the pool index and covers operators,
+        brackets and one-letter names, which are most tokens. */
+    static const int small_string_length = 1;
+    /** The maximum number of names, a power of two.
+        Each takes 16 bytes, and numbers, devices and groups share it. */
+    static const int max_num_symbols = 64;
+    /** The maximum number of numbers.
+        About as many names as the allocator and string pool held before
+        names got their own table, and each takes 2 bytes. */
+    static const int max_num_numbers = 48;
+    /** The maximum number of devices. */
+    static const int max_num_devices = 8;
+    /** The maximum number of command groups.
+        Their commands share the group store below, so more groups than
+        this only hold a few commands each. */
+    static const int max_num_groups = 12;
+    /** The maximum number of commands held by all command groups together.
+        The string pool runs out of space for more commands than this first. */
+    static const int max_num_group_commands = 48;
+    /** The number of bytes of compiled code held by all command groups together. */
+    static const int group_code_bytes = 384;
+    /** The maximum number of bytes of compiled code of one command. */
+    static const int max_code_length = 128;
+    /** The maximum number of values on the stack when evaluating compiled code. */
+    static const int max_eval_depth = 16;
+    /** The maximum number of nested if and else blocks. */
+    static const int max_scope_depth = 8;
+    /** The maximum number of groups and if and else blocks running inside each other.
+        A group running itself from inside an if block takes two per level. */
+    static const int max_frame_depth = 16;
+    /** The number of values a small local deque holds without allocating. */
+    static const int small_deque_size = 4;
 #else // When running on desktop console
     /** The number of blocks in the allocator. */
     static const int alloc_size = 200;
     /** The number of bytes that makes up one allocator block. */
     static const int alloc_block_size = sizeof(int) * 16;
+    /** The block sizes of the slab allocator classes, smallest first. */
+    static const int slab_block_size_0 = sizeof(int) * 6;
+    static const int slab_block_size_1 = sizeof(int) * 8;
+    static const int slab_block_size_2 = sizeof(int) * 12;
+    static const int slab_block_size_3 = sizeof(int) * 16;
+    /** The number of blocks in each slab allocator class. */
+    static const int slab_size_0 = 200;
+    static const int slab_size_1 = 50;
+    static const int slab_size_2 = 200;
+    static const int slab_size_3 = 50;
     /** The number of strings in the stringpool. */
-    static const int stringpool_size = 200;
+    static const int stringpool_size = 250;
     /** The maximum number of characters per string. */
-    static const int string_length = 128;
+    static const int string_length = 255;
+    /** The number of bytes that the characters of all strings are packed into. */
+    static const int stringpool_bytes = 16384;
+    /** The maximum number of characters of a string stored inside a PoolString. */
+    static const int small_string_length = 5;
+    /** The maximum number of names, a power of two. */
+    static const int max_num_symbols = 256;
+    /** The maximum number of numbers. */
+    static const int max_num_numbers = 128;
+    /** The maximum number of devices. */
+    static const int max_num_devices = 32;
+    /** The maximum number of command groups. */
+    static const int max_num_groups = 64;
+    /** The maximum number of commands held by all command groups together. */
+    static const int max_num_group_commands = 1024;
+    /** The number of bytes of compiled code held by all command groups together. */
+    static const int group_code_bytes = 16384;
+    /** The maximum number of bytes of compiled code of one command. */
+    static const int max_code_length = 512;
+    /** The maximum number of values on the stack when evaluating compiled code. */
+    static const int max_eval_depth = 64;
+    /** The maximum number of nested if and else blocks. */
+    static const int max_scope_depth = 32;
+    /** The maximum number of groups and if and else blocks running inside each other.
+        A group running itself from inside an if block takes two per level. */
+    static const int max_frame_depth = 160;
+    /** The number of values a small local deque holds without allocating. */
+    static const int small_deque_size = 8;
 #endif
 
 private:
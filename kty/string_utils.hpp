@@ -1,7 +1,9 @@
 #pragma once
 
 #include <kty/containers/string.hpp>
+#include <kty/containers/string_view.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/types.hpp>
 #include <kty/utils.hpp>
 
@@ -157,13 +159,13 @@ namespace kty {
     @param  str
             The string to be converted.
             The string can be prefixed with a '-', which indicates a negative number.
+            Pool strings are viewed in place, without being copied.
 
     @return The int represented in the string.
             If the string is invalid, 0 is returned.
 */
-template <typename PoolString = PoolString<>>
-int str_to_int(PoolString const & str) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+int str_to_int(StringView const & str) {
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     int len = str.strlen();
     if (len == 0) {
         return 0;
@@ -206,7 +208,7 @@ int str_to_int(PoolString const & str) {
 */
 template <typename GetPoolFunc = decltype(get_stringpool), typename PoolString = PoolString<>>
 PoolString int_to_str(int i, GetPoolFunc & getPoolFunc = get_stringpool) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     char strChar[2] = "";
     bool isNegative = false;
     if (i < 0) {
@@ -214,25 +216,21 @@ PoolString int_to_str(int i, GetPoolFunc & getPoolFunc = get_stringpool) {
         i *= -1;
     }
     PoolString output(getPoolFunc);
-    // output will contain digits in reverse order
+    // output will contain digits in reverse order, followed by the sign
     while (i > 0) {
         strChar[0] = (char)(i % 10 + '0');
         output += strChar;
         i /= 10;
     }
-    // Reverse digits to correct order
+    if (isNegative) {
+        output += "-";
+    }
+    // Reverse to correct order
     int len = output.strlen();
     char* cstr = output.c_str();
     for (int j = 0; j < len / 2; ++j) {
         swap(cstr[j], cstr[len - j - 1]);
     }
-    // Add negative sign if necessary
-    if (isNegative) {
-        for (int j = len + 1; j > 0; --j) {
-            cstr[j] = cstr[j - 1];            
-        }
-        cstr[0] = '-';
-    }
     return output;
 }
 
@@ -245,7 +243,7 @@ PoolString int_to_str(int i, GetPoolFunc & getPoolFunc = get_stringpool) {
 */
 template <typename PoolString = PoolString<>>
 void remove_str_whitespace(PoolString & str) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     PoolString temp(str);
     temp = "";
     char str_[2] = " ";
@@ -269,7 +267,7 @@ void remove_str_whitespace(PoolString & str) {
 */
 template <typename PoolString = PoolString<>>
 void remove_str_multiple_whitespace(PoolString & str) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     PoolString temp(str);
     temp = "";
     char str_[2] = " ";
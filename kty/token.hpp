@@ -2,6 +2,7 @@
 
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/types.hpp>
 
 namespace kty {
@@ -38,7 +39,7 @@ public:
     */
     explicit Token(GetPoolFunc & getPoolFunc = get_stringpool)
         : value_(getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         type_ = TokenType::UNKNOWN_TOKEN;
     }
 
@@ -53,7 +54,7 @@ public:
     */
     Token(TokenType type, GetPoolFunc & getPoolFunc = get_stringpool) 
         : value_(getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         type_ = type;
     }
 
@@ -68,7 +69,7 @@ public:
     */
     Token(TokenType type, PoolString<> const & value) 
         : value_(value) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         type_ = type;
         value_ = value;
     }
@@ -87,7 +88,7 @@ public:
     */
     Token(TokenType type, char const * value, GetPoolFunc & getPoolFunc = get_stringpool) 
         : value_(getPoolFunc) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         type_ = type;
         value_ = value;
     }
@@ -99,7 +100,7 @@ public:
                 The type to set to.
     */
     void set_type(TokenType type) {
-        Log.verbose(F("%s: setting to %d\n"), PRINT_FUNC, type);
+        KTY_LOG_VERBOSE(F("%s: setting to %d\n"), PRINT_FUNC, type);
         type_ = type;
     }
 
@@ -109,7 +110,7 @@ public:
         @return The type of the token.
     */
     TokenType get_type() const {
-        Log.verbose(F("%s: getting %d\n"), PRINT_FUNC, type_);
+        KTY_LOG_VERBOSE(F("%s: getting %d\n"), PRINT_FUNC, type_);
         return type_;
     }
 
@@ -120,7 +121,7 @@ public:
                 The value to set to.
     */
     void set_value(PoolString<> const & value) {
-        Log.verbose(F("%s: setting to %s\n"), PRINT_FUNC, value.c_str());
+        KTY_LOG_VERBOSE(F("%s: setting to %s\n"), PRINT_FUNC, value.c_str());
         value_ = value;
     }
 
@@ -130,7 +131,7 @@ public:
         @return A copy of the value of the token.
     */
     PoolString<> get_value() const {
-        Log.verbose(F("%s: getting %s\n"), PRINT_FUNC, value_.c_str());
+        KTY_LOG_VERBOSE(F("%s: getting %s\n"), PRINT_FUNC, value_.c_str());
         return value_;
     }
 
@@ -140,7 +141,7 @@ public:
         @return The string representaion of the token.
     */
     PoolString<> str() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Copy assignment so we don't need to store the pool
         PoolString<> result(value_);
         result = "Token(";
@@ -148,7 +149,7 @@ public:
         result += ", ";
         result += value_;
         result += ")";
-        Log.verbose(F("%s: result %s\n"), PRINT_FUNC, result.c_str());
+        KTY_LOG_VERBOSE(F("%s: result %s\n"), PRINT_FUNC, result.c_str());
         return result;
     }
 
@@ -158,7 +159,7 @@ public:
         @return The string representation of the type of the token.
     */
     char const * type_as_c_str() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         static const char lookup[][14] = {
             "CREATE_NUM",
             "CREATE_LED",
@@ -197,7 +198,7 @@ public:
             "CMD_END",
             "UNKNOWN_TOKEN",
         };
-        Log.verbose(F("%s: %s\n"), PRINT_FUNC, lookup[static_cast<int>(type_)]);
+        KTY_LOG_VERBOSE(F("%s: %s\n"), PRINT_FUNC, lookup[static_cast<int>(type_)]);
         return lookup[static_cast<int>(type_)];
     }
 
@@ -208,7 +209,7 @@ public:
                 If the token is not an operator, 0 is returned.
     */
     int precedence_level() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         static const int lookup[] = {
             0, // CREATE_NUM
             0, // CREATE_LED
@@ -247,7 +248,7 @@ public:
             0, // CMD_END,
             0, // UNKNOWN_TOKEN,
         };
-        Log.verbose(F("%s: %d\n"), PRINT_FUNC, lookup[static_cast<int>(type_)]);
+        KTY_LOG_VERBOSE(F("%s: %d\n"), PRINT_FUNC, lookup[static_cast<int>(type_)]);
         return lookup[static_cast<int>(type_)];
     }
 
@@ -258,7 +259,7 @@ public:
                 If this token is not a function, returns 0.
     */
     int num_function_arguments() const {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         static const int lookup[] = {
             1, // CREATE_NUM
             2, // CREATE_LED
@@ -297,7 +298,7 @@ public:
             0, // CMD_END,
             0, // UNKNOWN_TOKEN,
         };
-        Log.verbose(F("%s: %d\n"), PRINT_FUNC, lookup[static_cast<int>(type_)]);
+        KTY_LOG_VERBOSE(F("%s: %d\n"), PRINT_FUNC, lookup[static_cast<int>(type_)]);
         return lookup[static_cast<int>(type_)];
     }
 
@@ -760,10 +761,10 @@ private:
             the unknown token type is returned.
 */
 TokenType command_str_to_token_type(char const * str) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     TokenType tokenType = TokenType::UNKNOWN_TOKEN;
     if (::strlen(str) == 0) {
-        Log.warning(F("%s: empty string\n"), PRINT_FUNC);
+        KTY_LOG_WARNING(F("%s: empty string\n"), PRINT_FUNC);
         return TokenType::UNKNOWN_TOKEN;
     }
     static const char lookup[][10] = {
@@ -786,12 +787,12 @@ TokenType command_str_to_token_type(char const * str) {
     static const int numTypes = sizeof(lookup) / sizeof(lookup[0]);
     for (int i = 0; i < numTypes; ++i) {
         if (::strcmp(str, lookup[i]) == 0) {
-            Log.verbose(F("%s: %d\n"), PRINT_FUNC, static_cast<TokenType>(i));
+            KTY_LOG_VERBOSE(F("%s: %d\n"), PRINT_FUNC, static_cast<TokenType>(i));
             tokenType = static_cast<TokenType>(i);
         }
     }
     if (tokenType == TokenType::UNKNOWN_TOKEN) {
-        Log.warning(F("%s: unknown command string %s\n"), PRINT_FUNC, str);
+        KTY_LOG_WARNING(F("%s: unknown command string %s\n"), PRINT_FUNC, str);
     }
     return tokenType;
 }
@@ -807,12 +808,12 @@ TokenType command_str_to_token_type(char const * str) {
             the unknown token type is returned.
 */
 TokenType command_str_to_token_type(PoolString<> const & str) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     return command_str_to_token_type(str.c_str());
 
     TokenType tokenType = TokenType::UNKNOWN_TOKEN;
     if (str.strlen() == 0) {
-        Log.warning(F("%s: empty string\n"), PRINT_FUNC);
+        KTY_LOG_WARNING(F("%s: empty string\n"), PRINT_FUNC);
         return TokenType::UNKNOWN_TOKEN;
     }
     static const char lookup[][10] = {
@@ -835,12 +836,12 @@ TokenType command_str_to_token_type(PoolString<> const & str) {
     static const int numTypes = sizeof(lookup) / sizeof(lookup[0]);
     for (int i = 0; i < numTypes; ++i) {
         if (str == lookup[i]) {
-            Log.verbose(F("%s: %d\n"), PRINT_FUNC, static_cast<TokenType>(i));
+            KTY_LOG_VERBOSE(F("%s: %d\n"), PRINT_FUNC, static_cast<TokenType>(i));
             tokenType = static_cast<TokenType>(i);
         }
     }
     if (tokenType == TokenType::UNKNOWN_TOKEN) {
-        Log.warning(F("%s: unknown command string %s\n"), PRINT_FUNC, str.c_str());
+        KTY_LOG_WARNING(F("%s: unknown command string %s\n"), PRINT_FUNC, str.c_str());
     }
     return tokenType;
 }
@@ -856,7 +857,7 @@ TokenType command_str_to_token_type(PoolString<> const & str) {
             the unknown token type is returned.
 */
 TokenType punctuation_char_to_token_type(char const & ch) {
-    Log.verbose(F("%s\n"), PRINT_FUNC);
+    KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     switch (ch) {
     case '(':
         return TokenType::OP_PAREN;
@@ -891,7 +892,7 @@ TokenType punctuation_char_to_token_type(char const & ch) {
     case '~':
         return TokenType::LOGI_NOT;
     };
-    Log.warning(F("%s: unknown token %c\n"), PRINT_FUNC, ch);
+    KTY_LOG_WARNING(F("%s: unknown token %c\n"), PRINT_FUNC, ch);
     return TokenType::UNKNOWN_TOKEN;
 }
 
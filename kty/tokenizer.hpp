@@ -3,7 +3,9 @@
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/deque.hpp>
 #include <kty/containers/string.hpp>
+#include <kty/containers/string_view.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/log.hpp>
 #include <kty/string_utils.hpp>
 #include <kty/token.hpp>
 #include <kty/types.hpp>
@@ -30,7 +32,7 @@ public:
     Tokenizer(GetAllocFunc & getAllocFunc = get_alloc, GetPoolFunc & getPoolFunc = get_stringpool) 
         : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc), command_(getPoolFunc),
           validPunctuation_(get_stringpool, "(),=<>+-*/%^&|!~") {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
     }
 
     /*!
@@ -48,7 +50,7 @@ public:
     Tokenizer(GetAllocFunc & getAllocFunc, GetPoolFunc & getPoolFunc, PoolString const & command) 
         : getAllocFunc_(&getAllocFunc), getPoolFunc_(&getPoolFunc), command_(getPoolFunc),
           validPunctuation_(getPoolFunc, "(),=<>+-*/%^&|!~") {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         set_command(command);
     }
 
@@ -59,7 +61,7 @@ public:
                 The command to tokenize.
     */
     void set_command(PoolString const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         command_ = command;
         //remove_str_whitespace(command_);
         remove_str_multiple_whitespace(command_);
@@ -73,15 +75,16 @@ public:
         @return The tokenized command.
     */
     Deque<Token> tokenize() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         Deque<Token> tokens(*getAllocFunc_);
         tokens.clear();
         Token token(TokenType::UNKNOWN_TOKEN, *getPoolFunc_);
         do {
             token = get_next_token();
-            Log.verbose(F("%s: next token is %s\n"), PRINT_FUNC, token.str().c_str());
+            KTY_LOG_VERBOSE(F("%s: next token is %s\n"), PRINT_FUNC, token.str().c_str());
             if (!token.is_unknown_token()) {
-                tokens.push_back(token);
+                // Only the value is moved out, the type is still there for the loop check
+                tokens.push_back(move(token));
             }
         } while (!token.is_cmd_end());
         process_math_tokens(tokens);
@@ -97,7 +100,7 @@ public:
         @return The tokenized command.
     */
     Deque<Token> tokenize(PoolString const & command) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         set_command(command);
         return tokenize();
     }
@@ -110,7 +113,7 @@ public:
                 The tokenized command.
     */
     void process_math_tokens(Deque<Token> & tokens) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         // Compresses '<' + '=' into '<=' and '>' + '=' into '>='
         typename Deque<Token>::Iterator iter = tokens.begin();
         while (iter != tokens.end()) {
@@ -118,12 +121,12 @@ public:
             ++next;
             if (next != tokens.end()) {
                 if (iter->is_less() && next->is_equals()) {
-                    Log.verbose(F("%s: compressing into <=\n"), PRINT_FUNC);
+                    KTY_LOG_VERBOSE(F("%s: compressing into <=\n"), PRINT_FUNC);
                     iter->set_type(TokenType::L_EQUALS);
                     next = tokens.erase(next);
                 }
                 else if (iter->is_greater() && next->is_equals()) {
-                    Log.verbose(F("%s: compressing into >=\n"), PRINT_FUNC);
+                    KTY_LOG_VERBOSE(F("%s: compressing into >=\n"), PRINT_FUNC);
                     iter->set_type(TokenType::G_EQUALS);
                     next = tokens.erase(next);
                 }
@@ -139,7 +142,7 @@ public:
                 if (iter == tokens.begin() ||
                     prev->is_operator() ||
                     prev->is_op_paren()) {
-                    Log.verbose(F("%s: changing to unary -\n"), PRINT_FUNC);
+                    KTY_LOG_VERBOSE(F("%s: changing to unary -\n"), PRINT_FUNC);
                     iter->set_type(TokenType::UNARY_NEG);
                 }
             }
@@ -152,8 +155,8 @@ public:
         @return The next token from the stored command.
     */
     Token get_next_token() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        while (tokenStartIdx_ < command_.strlen() && isspace(command_[tokenStartIdx_])) {
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        while (tokenStartIdx_ < command_.strlen() && isspace(command_at(tokenStartIdx_))) {
             ++tokenStartIdx_;
         }
         // No more tokens
@@ -161,30 +164,30 @@ public:
             return Token(TokenType::CMD_END, *getPoolFunc_);
         }
         // Next token is command word
-        if (isupper(command_[tokenStartIdx_])) {
+        if (isupper(command_at(tokenStartIdx_))) {
             return get_next_command_token();
         }
         // Next token is name
-        else if (islower(command_[tokenStartIdx_]) || command_[tokenStartIdx_] == '_') {
+        else if (islower(command_at(tokenStartIdx_)) || command_at(tokenStartIdx_) == '_') {
             return get_next_name_token();
         }
         // Next token is number
-        else if (isdigit(command_[tokenStartIdx_])) {
+        else if (isdigit(command_at(tokenStartIdx_))) {
             return get_next_number_token();
         }
         // Next token is string
-        else if (command_[tokenStartIdx_] == '"') {
+        else if (command_at(tokenStartIdx_) == '"') {
             return get_next_string_token('"');
         }
-        else if (command_[tokenStartIdx_] == '\'') {
+        else if (command_at(tokenStartIdx_) == '\'') {
             return get_next_string_token('\'');
         }
         // Next token is punctuation
-        else if (validPunctuation_.find(command_[tokenStartIdx_]) != -1) {
+        else if (validPunctuation_.find(command_at(tokenStartIdx_)) != -1) {
             return get_next_punctuation_token();            
         }
         ++tokenStartIdx_;
-        Log.warning(F("%s: unknown token %c\n"), PRINT_FUNC, command_[tokenStartIdx_ - 1]);
+        KTY_LOG_WARNING(F("%s: unknown token %c\n"), PRINT_FUNC, command_at(tokenStartIdx_ - 1));
         return Token(TokenType::UNKNOWN_TOKEN, *getPoolFunc_);
     }
 
@@ -195,35 +198,40 @@ public:
                 If the next token is not a command, an unknown token is returned.
     */
     Token get_next_command_token() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         Token token(TokenType::UNKNOWN_TOKEN, *getPoolFunc_);
+        StringView command = command_view();
         for (int i = 0; i < commandLookupSize_; ++i) {
-            if (command_.find(get_command_lookup()[i], tokenStartIdx_) == tokenStartIdx_) {
+            if (command.starts_with(get_command_lookup()[i], tokenStartIdx_)) {
                 tokenStartIdx_ += ::strlen(get_command_lookup()[i]);
                 token.set_type(command_str_to_token_type(get_command_lookup()[i]));
                 return token;
             }
         }
-        Log.warning(F("%s: not a valid command\n"), PRINT_FUNC);
+        KTY_LOG_WARNING(F("%s: not a valid command\n"), PRINT_FUNC);
         // Not a valid command,
         // Skip forward until the end of this word
-        for (++tokenStartIdx_; tokenStartIdx_ < command_.strlen() && islower(command_[tokenStartIdx_]); ++tokenStartIdx_);
+        for (++tokenStartIdx_; tokenStartIdx_ < command_.strlen() && islower(command_at(tokenStartIdx_)); ++tokenStartIdx_);
         return token;
     }
 
     /*!
         @brief  Gets the next name token from the stored command.
+                The name is interned, so that copies of it share one string.
 
         @return The next name token.
                 If the next token is not a name, an unknown token is returned.
     */
     Token get_next_name_token() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        StringView command = command_view();
         int currIdx = tokenStartIdx_;
-        while (currIdx < command_.strlen() && (islower(command_[currIdx]) || command_[currIdx] == '_')) {
+        while (currIdx < command.strlen() && (islower(command[currIdx]) || command[currIdx] == '_')) {
             ++currIdx;
         }
-        Token result(TokenType::NAME, command_.substr_ii(tokenStartIdx_, currIdx));
+        PoolString value(*getPoolFunc_);
+        value = command.substr_ii(tokenStartIdx_, currIdx);
+        Token result(TokenType::NAME, value.intern());
         tokenStartIdx_ = currIdx;
         return result;
     }
@@ -235,12 +243,15 @@ public:
                 If the next token is not a number, an unknown token is returned.
     */
     Token get_next_number_token() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        StringView command = command_view();
         int currIdx = tokenStartIdx_;
-        while (currIdx < command_.strlen() && isdigit(command_[currIdx])) {
+        while (currIdx < command.strlen() && isdigit(command[currIdx])) {
             ++currIdx;
         }
-        Token result(TokenType::NUM_VAL, command_.substr_ii(tokenStartIdx_, currIdx));
+        PoolString value(*getPoolFunc_);
+        value = command.substr_ii(tokenStartIdx_, currIdx);
+        Token result(TokenType::NUM_VAL, value);
         tokenStartIdx_ = currIdx;
         return result;
     }
@@ -256,10 +267,13 @@ public:
                 If the next token is not a string, an unknown token is returned.
     */
     Token get_next_string_token(char const & open) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        int endIdx = command_.find(open, tokenStartIdx_ + 1);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        StringView command = command_view();
+        int endIdx = command.find(open, tokenStartIdx_ + 1);
         // Only take substr of the string, without quotes
-        Token result(TokenType::STRING, command_.substr_ii(tokenStartIdx_ + 1, endIdx));
+        PoolString value(*getPoolFunc_);
+        value = command.substr_ii(tokenStartIdx_ + 1, endIdx);
+        Token result(TokenType::STRING, value);
         tokenStartIdx_ = endIdx + 1;
         return result;
     }
@@ -271,8 +285,8 @@ public:
                 If the next token is not punctuation, an unknown token is returned.
     */
     Token get_next_punctuation_token() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
-        Token result(punctuation_char_to_token_type(command_[tokenStartIdx_]), *getPoolFunc_);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
+        Token result(punctuation_char_to_token_type(command_at(tokenStartIdx_)), *getPoolFunc_);
         ++tokenStartIdx_;
         return result;    
     }
@@ -289,7 +303,7 @@ public:
         @return The remaining missing arguments, if any.
     */
     PoolString get_additional_arguments(TokenType tokenType, int const & numArguments) {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         PoolString arguments(*getPoolFunc_);
         switch (tokenType) {
         case TokenType::CREATE_NUM:
@@ -318,7 +332,7 @@ public:
         @brief  Adds the missing arguments, if any, for the functions present in the command.
     */
     void add_missing_optional_arguments() {
-        Log.verbose(F("%s\n"), PRINT_FUNC);
+        KTY_LOG_VERBOSE(F("%s\n"), PRINT_FUNC);
         for (int i = 0; i < commandLookupSize_; ++i) {
             int idx = command_.find(get_command_lookup()[i]);
             if (idx == -1) {
@@ -341,6 +355,32 @@ public:
         }
     }
 
+    /*!
+        @brief  Gets a character of the stored command.
+                Reading through a const string leaves its stored length
+                known, so the length checks while scanning stay cheap.
+
+        @param  i
+                The index of the character.
+
+        @return The character at the index.
+    */
+    char command_at(int const & i) const {
+        return command_[i];
+    }
+
+    /*!
+        @brief  Gets a view of the stored command, to scan a token in place.
+                Allocating from the pool can move the command's characters,
+                so the view is taken again for each token, and token values
+                are only copied into the pool once they have been found.
+
+        @return A view of the stored command.
+    */
+    StringView command_view() const {
+        return StringView(command_);
+    }
+
     /*!
         @brief  Get a 2D array containing all command words.
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+
 #if defined(ARDUINO)
 
 #define TYPE_STR(x) ""
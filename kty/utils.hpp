@@ -5,6 +5,37 @@
     Utility functions implemented here to remove reliance on the STL for arduino.
 */
 
+/*!
+    @brief  Removes the reference from a type.
+*/
+template <typename T>
+struct remove_reference {
+    typedef T type;
+};
+
+template <typename T>
+struct remove_reference<T &> {
+    typedef T type;
+};
+
+template <typename T>
+struct remove_reference<T &&> {
+    typedef T type;
+};
+
+/*!
+    @brief  Casts an item to an rvalue, so that it can be moved from.
+
+    @param  item
+            The item to move from.
+
+    @return An rvalue reference to the item.
+*/
+template <typename T>
+typename remove_reference<T>::type && move(T && item) {
+    return static_cast<typename remove_reference<T>::type &&>(item);
+}
+
 /*!
     @brief  Swaps two items.
 
@@ -16,15 +47,16 @@
 */
 template <typename T>
 void swap(T & first, T & second) {
-    T temp(first);
-    first = second;
-    second = temp;
+    T temp(move(first));
+    first = move(second);
+    second = move(temp);
 }
 
 #else
 
 #include <utility>
 
+using std::move;
 using std::swap;
 
 #endif
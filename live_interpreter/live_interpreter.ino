@@ -1,6 +1,9 @@
 #include <kitty.hpp>
 #include <ArduinoLog.h>
 
+// Logging above this level is compiled out, raise it to use a higher level in begin_logging()
+#define KTY_LOG_LEVEL KTY_LOG_LEVEL_WARNING
+
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/containers/stringpool.hpp>
@@ -10,7 +13,7 @@
 
 using namespace kty;
 
-Allocator<>         alloc;
+SlabAllocator<>     alloc;
 StringPool<>        stringPool;
 GetAllocInit<>      getAllocInit(alloc);
 GetStringPoolInit<> getStringPoolInit(stringPool);
@@ -38,6 +38,9 @@ loop_nums RunGroup(num_times)
 
 #include <ArduinoLog.h>
 
+// Logging above this level is compiled out, raise it to use a higher level in begin_logging()
+#define KTY_LOG_LEVEL KTY_LOG_LEVEL_WARNING
+
 #include <kitty.hpp>
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/string.hpp>
@@ -48,7 +51,7 @@ loop_nums RunGroup(num_times)
 
 using namespace kty;
 
-Allocator<>         alloc;
+SlabAllocator<>     alloc;
 StringPool<>        stringPool;
 GetAllocInit<>      getAllocInit(alloc);
 GetStringPoolInit<> getStringPoolInit(stringPool);
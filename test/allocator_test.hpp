@@ -118,3 +118,137 @@ test(allocator_allocate_deallocate)
 
     Test::min_verbosity = prevTestVerbosity;
 }
+
+test(allocator_free_list)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test allocator_free_list starting.");
+    const int numBlocks = 5;
+    Allocator<numBlocks, sizeof(int)> intAlloc;
+    int * blocks[numBlocks];
+
+    for (int i = 0; i < numBlocks; ++i) {
+        blocks[i] = (int *)(intAlloc.allocate());
+        assertTrue(blocks[i] != nullptr, "i = " << i);
+    }
+    assertEqual(intAlloc.available(), 0);
+
+    // A freed block from the middle of the pool is handed out next
+    assertTrue(intAlloc.deallocate(blocks[2]));
+    assertEqual(intAlloc.available(), 1);
+    assertTrue(intAlloc.allocate() == blocks[2]);
+    assertTrue(intAlloc.allocate() == nullptr);
+
+    // Decreasing the reference count to 0 returns the block to the pool
+    assertEqual(intAlloc.dec_ref_count(blocks[4]), 0);
+    assertEqual(intAlloc.dec_ref_count(blocks[4]), 0);
+    assertEqual(intAlloc.available(), 1);
+
+    // Increasing the reference count of a free block takes it out of the pool
+    assertTrue(intAlloc.deallocate(blocks[0]));
+    assertEqual(intAlloc.inc_ref_count(blocks[4]), 1);
+    assertEqual(intAlloc.available(), 1);
+    assertTrue(intAlloc.allocate() == blocks[0]);
+    assertTrue(intAlloc.allocate() == nullptr);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(allocator_slab_allocator)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test allocator_slab_allocator starting.");
+    SlabAllocator<2, 4, 2, 8, 2, 16, 2, 32> slab;
+    assertEqual(slab.available(), 8);
+    assertEqual(slab.block_size_for(1), 4);
+    assertEqual(slab.block_size_for(5), 8);
+    assertEqual(slab.block_size_for(16), 16);
+    assertEqual(slab.block_size_for(17), 32);
+    assertEqual(slab.block_size_for(33), -1);
+
+    // Each request is served by the smallest class that fits it
+    void * small = slab.allocate(3);
+    void * medium = slab.allocate(12);
+    assertTrue(small != nullptr);
+    assertTrue(medium != nullptr);
+    assertEqual(slab.available(3), 1);
+    assertEqual(slab.available(12), 1);
+    assertEqual(slab.available(8), 2);
+    assertEqual(slab.available(32), 2);
+    assertEqual(slab.num_taken(), 2);
+    assertTrue(slab.owns(small));
+    assertTrue(slab.owns(medium));
+
+    // A full class does not spill over into a larger class
+    assertTrue(slab.allocate(4) != nullptr);
+    assertTrue(slab.allocate(4) == nullptr);
+    assertEqual(slab.available(32), 2);
+    assertTrue(slab.allocate(33) == nullptr);
+
+    assertEqual(slab.ref_count(medium), 1);
+    assertEqual(slab.inc_ref_count(medium), 2);
+    assertEqual(slab.dec_ref_count(medium), 1);
+    assertTrue(slab.deallocate(small));
+    assertTrue(slab.deallocate(medium));
+    assertFalse(slab.deallocate(medium));
+    assertEqual(slab.available(3), 1);
+    assertEqual(slab.available(12), 2);
+    assertEqual(slab.max_num_taken(3), 2);
+    slab.reset_stat();
+    assertEqual(slab.max_num_taken(3), 1);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(allocator_alignment)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test allocator_alignment starting.");
+    // Blocks of every class can hold pointers, whichever classes come before them
+    int const sizes[] = {Sizes::slab_block_size_0, Sizes::slab_block_size_1, Sizes::slab_block_size_2, Sizes::slab_block_size_3};
+    for (int size : sizes) {
+        void * first = alloc.allocate(size);
+        void * second = alloc.allocate(size);
+        assertTrue(first != nullptr);
+        assertTrue(second != nullptr);
+        assertEqual(reinterpret_cast<uintptr_t>(first) % alignof(void *), 0);
+        assertEqual(reinterpret_cast<uintptr_t>(second) % alignof(void *), 0);
+        alloc.deallocate(first);
+        alloc.deallocate(second);
+    }
+    Allocator<4, Sizes::alloc_block_size> allocator;
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(reinterpret_cast<uintptr_t>(allocator.allocate()) % alignof(void *), 0);
+    }
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(allocator_slab_deque_nodes)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test allocator_slab_deque_nodes starting.");
+    int const intNodeSize = sizeof(Deque<int>::Node);
+    int const largestSize = decltype(alloc)::max_block_size;
+    assertTrue(decltype(alloc)::block_size_for(intNodeSize) < largestSize);
+
+    // Deque<int> nodes come from the smallest class that fits them
+    int intTaken = alloc.num_taken(intNodeSize);
+    int largestTaken = alloc.num_taken(largestSize);
+    {
+        Deque<int> ints;
+        for (int i = 0; i < 10; ++i) {
+            assertTrue(ints.push_back(i), "i = " << i);
+        }
+        // One node per value, the head is stored in the deque
+        assertEqual(alloc.num_taken(intNodeSize), intTaken + 10);
+        assertEqual(alloc.num_taken(largestSize), largestTaken);
+    }
+    assertEqual(alloc.num_taken(intNodeSize), intTaken);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <kty/bytecode.hpp>
+#include <kty/compiler.hpp>
+#include <kty/parser.hpp>
+#include <kty/sizes.hpp>
+#include <kty/token.hpp>
+#include <kty/tokenizer.hpp>
+
+using namespace kty;
+
+test(compiler_compile_commands)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test compiler_compile_commands starting.");
+    Tokenizer<> tokenizer;
+    Parser<> parser;
+    Compiler<> compiler;
+    unsigned char code[Sizes::max_code_length];
+    unsigned char * pc = code;
+
+    // Operands come first, in postfix order, then the function with its name
+    int len = compiler.compile(parser.parse(tokenizer.tokenize(PoolString<>("total IsNumber(total + 2 * step)"))));
+    assertTrue(len > 0);
+    memcpy(code, compiler.code(), len);
+    assertEqual(*pc++, OP_NAME);
+    assertEqual(Bytecode::read_binding(pc).slot(), -1);
+    pc += sizeof(SymbolBinding);
+    assertEqual(Bytecode::read_str(pc), "total");
+    assertEqual(*pc++, OP_INT);
+    assertEqual(Bytecode::read_int(pc), 2);
+    assertEqual(*pc++, OP_NAME);
+    pc += sizeof(SymbolBinding);
+    assertEqual(Bytecode::read_str(pc), "step");
+    assertEqual(*pc++, OP_BINARY);
+    assertEqual(*pc++, MATH_MUL);
+    assertEqual(*pc++, OP_BINARY);
+    assertEqual(*pc++, MATH_ADD);
+    assertEqual(*pc++, OP_CREATE_NUM);
+    pc += sizeof(SymbolBinding);
+    assertEqual(Bytecode::read_str(pc), "total");
+    assertEqual(*pc++, OP_END);
+    assertEqual(pc - code, len);
+
+    // Strings to print are kept as they are
+    len = compiler.compile(parser.parse(tokenizer.tokenize(PoolString<>("Print(\"n is \", (-n))"))));
+    assertTrue(len > 0);
+    memcpy(code, compiler.code(), len);
+    pc = code;
+    assertEqual(*pc++, OP_STR);
+    assertEqual(Bytecode::read_str(pc), "n is ");
+    assertEqual(*pc++, OP_NAME);
+    pc += sizeof(SymbolBinding);
+    assertEqual(Bytecode::read_str(pc), "n");
+    assertEqual(*pc++, OP_UNARY);
+    assertEqual(*pc++, UNARY_NEG);
+    assertEqual(*pc++, OP_PRINT);
+    assertEqual(*pc++, OP_END);
+
+    len = compiler.compile(parser.parse(tokenizer.tokenize(PoolString<>("blink RunGroup(3)"))));
+    assertTrue(len > 0);
+    memcpy(code, compiler.code(), len);
+    pc = code;
+    assertEqual(*pc++, OP_INT);
+    assertEqual(Bytecode::read_int(pc), 3);
+    assertEqual(*pc++, OP_RUN_GROUP);
+    pc += sizeof(SymbolBinding);
+    assertEqual(Bytecode::read_str(pc), "blink");
+    assertEqual(*pc++, OP_END);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(compiler_compile_too_long)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test compiler_compile_too_long starting.");
+    Tokenizer<> tokenizer;
+    Parser<> parser;
+    Compiler<> compiler;
+    int maxEvalDepth = Sizes::max_eval_depth;
+
+    // Values that would not all fit on the stack at once are refused
+    PoolString<> command("Print(1");
+    for (int i = 0; i < maxEvalDepth; ++i) {
+        command += ", 1";
+    }
+    command += ")";
+    assertEqual(compiler.compile(parser.parse(tokenizer.tokenize(command))), -1);
+
+    // Adding them up as they come keeps the stack short
+    command = "Print(1";
+    for (int i = 0; i < maxEvalDepth; ++i) {
+        command += " + 1";
+    }
+    command += ")";
+    assertTrue(compiler.compile(parser.parse(tokenizer.tokenize(command))) > 0);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
@@ -38,6 +38,14 @@ test(deque_of_deque_dequedequepoolstring_push_front_push_back)
     assertTrue(strings.push_back(0, string));
     assertFalse(strings.push_back(3, string));
 
+    // There is only space for a fixed number of deques
+    while (strings.size() < Sizes::max_num_groups) {
+        assertTrue(strings.push_front());
+    }
+    assertFalse(strings.push_front());
+    assertEqual(strings.size(), Sizes::max_num_groups);
+    strings.clear();
+
     Test::min_verbosity = prevTestVerbosity;
 }
 
@@ -93,13 +101,18 @@ test(deque_of_deque_dequedequepoolstring_get_str_get_str_idx)
 
     assertTrue(strings.push_front());
     assertTrue(strings.push_back(0, string));
-    assertEqual(strings.get_str(0, 0).c_str(), string.c_str());
+    PoolString<> str = strings.get_str(0, 0);
+    assertEqual(str.c_str(), string.c_str());
     assertEqual(get_stringpool(nullptr)->c_str(strings.get_str_idx(0, 0)), string.c_str());
 
-    assertEqual(strings.get_str(-1, 0).c_str(), "");
-    assertEqual(strings.get_str(1, 0).c_str(), "");
-    assertEqual(strings.get_str(0, -1).c_str(), "");
-    assertEqual(strings.get_str(0, 1).c_str(), "");
+    str = strings.get_str(-1, 0);
+    assertEqual(str.c_str(), "");
+    str = strings.get_str(1, 0);
+    assertEqual(str.c_str(), "");
+    str = strings.get_str(0, -1);
+    assertEqual(str.c_str(), "");
+    str = strings.get_str(0, 1);
+    assertEqual(str.c_str(), "");
 
     assertEqual(strings.get_str_idx(-1, 0), -1);
     assertEqual(strings.get_str_idx(1, 0), -1);
@@ -108,3 +121,195 @@ test(deque_of_deque_dequedequepoolstring_get_str_get_str_idx)
 
     Test::min_verbosity = prevTestVerbosity;
 }
+
+test(deque_of_deque_dequedequepoolstring_many_strings)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_of_deque_dequedequepoolstring_many_strings starting.");
+    DequeDequePoolString<> strings;
+    PoolString<> names[3] = {PoolString<>("first"), PoolString<>("second"), PoolString<>("third")};
+    int numStrings = Sizes::string_length + 8;
+
+    // The deques are filled in turns, so their strings are added out of order
+    for (int d = 0; d < 3; ++d) {
+        assertTrue(strings.push_back());
+    }
+    for (int j = 0; j < numStrings; ++j) {
+        assertTrue(strings.push_back(0, names[j % 3]), "j = " << j);
+        if (j < 5) {
+            assertTrue(strings.push_back(1, names[1]));
+            assertTrue(strings.push_back(2, names[2]));
+        }
+    }
+    assertEqual(strings.size(0), numStrings);
+    PoolString<> str;
+    for (int j = 0; j < numStrings; ++j) {
+        str = strings.get_str(0, j);
+        assertEqual(str.c_str(), names[j % 3].c_str(), "j = " << j);
+    }
+
+    // Clearing one deque leaves the strings of the others in place
+    assertTrue(strings.clear(1));
+    assertEqual(strings.size(1), 0);
+    assertTrue(strings.push_back(1, names[0]));
+    str = strings.get_str(1, 0);
+    assertEqual(str.c_str(), names[0].c_str());
+    assertEqual(strings.size(2), 5);
+    for (int j = 0; j < 5; ++j) {
+        str = strings.get_str(2, j);
+        assertEqual(str.c_str(), names[2].c_str(), "j = " << j);
+    }
+    assertTrue(strings.clear(0));
+    str = strings.get_str(1, 0);
+    assertEqual(str.c_str(), names[0].c_str());
+    str = strings.get_str(2, 4);
+    assertEqual(str.c_str(), names[2].c_str());
+
+    // The strings of all deques together are limited
+    while (strings.push_back(2, names[2])) {
+    }
+    assertEqual(strings.size(1) + strings.size(2), Sizes::max_num_group_commands);
+    assertTrue(strings.clear());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_of_deque_dequedequepoolstring_high_str_idx)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_of_deque_dequedequepoolstring_high_str_idx starting.");
+    DequeDequePoolString<> strings;
+    PoolString<> string("high_str_idx");
+    Deque<int> taken;
+
+    // Get an index past the range of a signed char to hold the string
+    int idx = get_stringpool(nullptr)->allocate_idx();
+    while (idx != -1 && idx < 128) {
+        taken.push_back(idx);
+        idx = get_stringpool(nullptr)->allocate_idx();
+    }
+    get_stringpool(nullptr)->deallocate_idx(idx);
+
+    strings.push_front();
+    strings.push_back(0, string);
+    int strIdx = strings.get_str_idx(0, 0);
+    bool strMatches = strings.get_str(0, 0) == string;
+    strings.clear();
+    int refCount = get_stringpool(nullptr)->ref_count(strIdx);
+
+    // Return the indices before checking, so a failure does not leak them
+    for (int i = 0; i < taken.size(); ++i) {
+        get_stringpool(nullptr)->deallocate_idx(taken[i]);
+    }
+    assertNotEqual(idx, -1);
+    assertTrue(strIdx >= 128, "strIdx = " << strIdx);
+    assertTrue(strMatches);
+    assertEqual(refCount, 0);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_of_deque_dequedequepoolstring_code)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test deque_of_deque_dequedequepoolstring_code starting.");
+    DequeDequePoolString<> strings;
+    PoolString<> string("code");
+    unsigned char code[] = {1, 2, 3, 4, 5};
+
+    strings.push_back();
+    strings.push_back();
+    strings.push_back(0, string);
+    strings.push_back(1, string);
+    strings.push_back(1, string);
+    assertTrue(strings.get_code(0, 0) == nullptr);
+    assertTrue(strings.set_code(1, 0, code, 3));
+    assertTrue(strings.set_code(1, 1, code + 3, 2));
+    assertTrue(strings.set_code(0, 0, code + 1, 1));
+    assertEqual(strings.get_code(0, 0)[0], 2);
+    assertEqual(strings.get_code(1, 0)[2], 3);
+    assertEqual(strings.get_code(1, 1)[1], 5);
+
+    // Code moves along with the strings around it
+    strings.push_back(0, string);
+    assertTrue(strings.get_code(0, 1) == nullptr);
+    assertEqual(strings.get_code(1, 0)[0], 1);
+    assertTrue(strings.set_code(1, 0, code + 4, 1));
+    assertEqual(strings.get_code(1, 0)[0], 5);
+    assertEqual(strings.get_code(1, 1)[0], 4);
+    assertTrue(strings.clear(0));
+    assertEqual(strings.get_code(1, 0)[0], 5);
+    assertEqual(strings.get_code(1, 1)[1], 5);
+    assertFalse(strings.set_code(0, 0, code, 1));
+
+    // The code of all strings together is limited
+    int groupCodeBytes = Sizes::group_code_bytes;
+    unsigned char bigCode[Sizes::group_code_bytes] = {};
+    assertFalse(strings.set_code(1, 0, bigCode, groupCodeBytes));
+    assertEqual(strings.get_code(1, 1)[0], 4);
+    assertTrue(strings.clear());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_of_deque_dequedequepoolstring_pop_back_replace)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test deque_of_deque_dequedequepoolstring_pop_back_replace starting.");
+    DequeDequePoolString<> strings;
+    unsigned char code[] = {1, 2, 3};
+
+    assertFalse(strings.pop_back());
+    strings.push_back();
+    strings.push_back();
+    strings.push_back(0, PoolString<>("old0"));
+    strings.push_back(0, PoolString<>("old1"));
+    strings.push_back(1, PoolString<>("other"));
+    assertTrue(strings.set_code(0, 1, code, 2));
+    assertTrue(strings.set_code(1, 0, code + 2, 1));
+    assertEqual(strings.get_code_size(0, 0), 0);
+    assertEqual(strings.get_code_size(0, 1), 2);
+    assertEqual(strings.get_code_size(2, 0), 0);
+
+    // The last deque is dropped along with its code
+    strings.push_back();
+    strings.push_back(2, PoolString<>("dropped"));
+    assertTrue(strings.set_code(2, 0, code, 3));
+    assertTrue(strings.pop_back());
+    assertEqual(strings.size(), 2);
+    assertEqual(strings.get_code_size(1, 0), 1);
+
+    // The last deque takes the place of the first one
+    strings.push_back();
+    strings.push_back(2, PoolString<>("new0"));
+    assertTrue(strings.set_code(2, 0, code + 1, 2));
+    assertFalse(strings.replace(2));
+    assertFalse(strings.replace(-1));
+    assertTrue(strings.replace(0));
+    assertEqual(strings.size(), 2);
+    assertEqual(strings.size(0), 1);
+    PoolString<> str = strings.get_str(0, 0);
+    assertEqual(str.c_str(), "new0");
+    assertEqual(strings.get_code_size(0, 0), 2);
+    assertEqual(strings.get_code(0, 0)[1], 3);
+    str = strings.get_str(1, 0);
+    assertEqual(str.c_str(), "other");
+    assertEqual(strings.get_code(1, 0)[0], 3);
+
+    // Both deques can still grow after the replace
+    strings.push_back(0, PoolString<>("new1"));
+    strings.push_back(1, PoolString<>("other1"));
+    str = strings.get_str(0, 1);
+    assertEqual(str.c_str(), "new1");
+    str = strings.get_str(1, 1);
+    assertEqual(str.c_str(), "other1");
+    assertEqual(strings.get_code(0, 0)[0], 2);
+    assertEqual(strings.get_code(1, 0)[0], 3);
+    assertTrue(strings.clear());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
@@ -26,7 +26,7 @@ test(deque_front) {
     Serial.println("Test deque_front starting.");
 
     const int numInts = 10;
-    Allocator<numInts + 1, Sizes::alloc_block_size> alloc;
+    Allocator<numInts, Sizes::alloc_block_size> alloc;
     Deque<int, decltype(alloc)> deque(alloc);
     assertNotEqual(deque.front(), -1);
     for (int i = 0; i < numInts; ++i) {
@@ -57,7 +57,7 @@ test(deque_back) {
     
     Serial.println("Test deque_back starting.");
     const int numInts = 10;
-    Allocator<numInts + 1, Sizes::alloc_block_size> alloc;
+    Allocator<numInts, Sizes::alloc_block_size> alloc;
     Deque<int, decltype(alloc)> deque(alloc);
     assertNotEqual(deque.back(), -1);
     for (int i = 0; i < numInts; ++i) {
@@ -150,3 +150,207 @@ test(deque_erase) {
 
     Test::min_verbosity = prevTestVerbosity;
 }
+
+test(deque_move_and_swap) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_move_and_swap starting.");
+    Allocator<8, Sizes::alloc_block_size> alloc;
+    Deque<int, decltype(alloc)> deque1(alloc);
+    assertTrue(deque1.push_back(1));
+    assertTrue(deque1.push_back(2));
+    assertEqual(alloc.available(), 6);
+
+    // Moving takes over the nodes without allocating
+    Deque<int, decltype(alloc)> deque2(move(deque1));
+    assertEqual(alloc.available(), 6);
+    assertEqual(deque1.size(), 0);
+    assertEqual(deque2.size(), 2);
+    assertEqual(deque2.front(), 1);
+    assertEqual(deque2.back(), 2);
+
+    // A moved from deque can be assigned to again
+    deque1 = deque2;
+    assertEqual(alloc.available(), 4);
+    assertEqual(deque1.size(), 2);
+    assertEqual(deque1.back(), 2);
+    deque1.pop_back();
+
+    // Swapping only exchanges the nodes
+    deque1.swap(deque2);
+    assertEqual(alloc.available(), 5);
+    assertEqual(deque1.size(), 2);
+    assertEqual(deque2.size(), 1);
+    assertEqual(deque2.front(), 1);
+
+    // Move assignment hands the old nodes to the other deque
+    deque2 = move(deque1);
+    assertEqual(deque2.size(), 2);
+    assertEqual(deque1.size(), 1);
+    assertTrue(deque2.push_back(3));
+    assertEqual(deque2.back(), 3);
+    assertEqual(alloc.available(), 4);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_splice) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_splice starting.");
+    Allocator<16, Sizes::alloc_block_size> alloc;
+    Deque<int, decltype(alloc)> deque1(alloc);
+    Deque<int, decltype(alloc)> deque2(alloc);
+    deque1.push_back(3);
+    deque1.push_back(4);
+    deque2.push_back(1);
+    deque2.push_back(2);
+    assertEqual(alloc.available(), 12);
+
+    // Splicing relinks the nodes without allocating
+    assertTrue(deque1.splice_front(deque2));
+    assertEqual(alloc.available(), 12);
+    assertTrue(deque2.is_empty());
+    assertEqual(deque1.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(deque1[i], i + 1, "i = " << i);
+    }
+    assertTrue(deque2.splice_back(deque1));
+    assertTrue(deque1.is_empty());
+    assertTrue(deque1.splice_back(deque2));
+    assertTrue(deque1.splice_front(deque2));
+    assertEqual(deque1.size(), 4);
+    deque2.push_back(5);
+    assertTrue(deque1.splice_back(deque2));
+    assertEqual(alloc.available(), 11);
+    assertEqual(deque1.size(), 5);
+    assertEqual(deque1.back(), 5);
+    assertTrue(deque2.push_back(6));
+    assertEqual(deque2.front(), 6);
+
+    // Deques with a different allocator move their elements over instead
+    decltype(alloc) otherAlloc;
+    Deque<int, decltype(alloc)> deque3(otherAlloc);
+    deque3.push_back(0);
+    assertTrue(deque1.splice_front(deque3));
+    assertTrue(deque3.is_empty());
+    assertEqual(deque1.size(), 6);
+    for (int i = 0; i < 6; ++i) {
+        assertEqual(deque1[i], i, "i = " << i);
+    }
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_append_range) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_append_range starting.");
+    Allocator<16, Sizes::alloc_block_size> alloc;
+    Deque<int, decltype(alloc)> deque1(alloc);
+    Deque<int, decltype(alloc)> deque2(alloc);
+    for (int i = 0; i < 5; ++i) {
+        deque2.push_back(i);
+    }
+    assertEqual(alloc.available(), 11);
+
+    // Only the elements in the range are moved over
+    Deque<int, decltype(alloc)>::Iterator first = deque2.begin();
+    ++first;
+    Deque<int, decltype(alloc)>::Iterator last = first;
+    ++last;
+    ++last;
+    assertTrue(deque1.append_range(deque2, first, last));
+    assertEqual(alloc.available(), 11);
+    assertEqual(deque1.size(), 2);
+    assertEqual(deque1.front(), 1);
+    assertEqual(deque1.back(), 2);
+    assertEqual(deque2.size(), 3);
+    assertEqual(deque2[0], 0);
+    assertEqual(deque2[1], 3);
+
+    assertTrue(deque1.append_range(deque2, deque2.end(), deque2.end()));
+    assertFalse(deque1.append_range(deque1, deque1.begin(), deque1.end()));
+    assertTrue(deque1.append_range(deque2, deque2.begin(), deque2.end()));
+    assertTrue(deque2.is_empty());
+    assertEqual(deque1.size(), 5);
+    assertEqual(deque1[2], 0);
+    assertEqual(deque1[4], 4);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_inline_nodes) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_inline_nodes starting.");
+    Allocator<8, Sizes::alloc_block_size> alloc;
+    typedef Deque<int, decltype(alloc), decltype(get_alloc), 2> SmallDeque;
+
+    // Empty deques and the first values of small deques take no blocks
+    Deque<int, decltype(alloc)> empty(alloc);
+    SmallDeque deque1(alloc);
+    assertTrue(deque1.push_back(2));
+    assertTrue(deque1.push_front(1));
+    assertEqual(alloc.available(), 8);
+    assertTrue(deque1.push_back(3));
+    assertEqual(alloc.available(), 7);
+    assertEqual(deque1[0], 1);
+    assertEqual(deque1[2], 3);
+    assertTrue(deque1.pop_front());
+    assertTrue(deque1.push_back(4));
+    assertEqual(alloc.available(), 7);
+
+    // Values in the deque's own blocks are moved over rather than relinked
+    SmallDeque deque2(move(deque1));
+    assertTrue(deque1.is_empty());
+    assertEqual(deque2.size(), 3);
+    assertEqual(alloc.available(), 7);
+    deque1.push_back(5);
+    deque1.swap(deque2);
+    assertEqual(deque1.size(), 3);
+    assertEqual(deque1.front(), 2);
+    assertEqual(deque1.back(), 4);
+    assertEqual(deque2.size(), 1);
+    assertEqual(deque2.front(), 5);
+    assertTrue(deque2.splice_front(deque1));
+    assertEqual(deque2.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(deque2[i], i + 2, "i = " << i);
+    }
+    deque2.clear();
+    assertEqual(alloc.available(), 8);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(deque_static_alloc) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test deque_static_alloc starting.");
+    typedef Deque<int, SlabAllocator<>, StaticAlloc<SlabAllocator<>, &alloc>> StaticDeque;
+    int numTaken = alloc.num_taken();
+    {
+        // The allocator is named by the type, so the deque holds no pointers to it
+        assertTrue(sizeof(StaticDeque) < sizeof(Deque<int>));
+
+        StaticDeque deque1;
+        StaticDeque deque2;
+        for (int i = 0; i < 4; ++i) {
+            assertTrue(deque1.push_back(i), "i = " << i);
+        }
+        assertEqual(alloc.num_taken(), numTaken + 4);
+
+        // All deques of the type share the allocator, so nodes are relinked
+        assertTrue(deque2.splice_back(deque1));
+        assertTrue(deque1.is_empty());
+        assertEqual(deque2.size(), 4);
+        assertEqual(alloc.num_taken(), numTaken + 4);
+        StaticDeque deque3(deque2);
+        assertEqual(deque3.back(), 3);
+        assertEqual(alloc.num_taken(), numTaken + 8);
+    }
+    assertEqual(alloc.num_taken(), numTaken);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
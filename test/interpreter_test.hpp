@@ -1,5 +1,6 @@
 #pragma once
 
+#include <kty/compiler.hpp>
 #include <kty/containers/string.hpp>
 #include <kty/interpreter.hpp>
 #include <kty/parser.hpp>
@@ -35,20 +36,24 @@ test(interpreter_get_prompt_prefix)
     interpreter.reset();
     PoolString<> command;
 
-    assertEqual(interpreter.get_prompt_prefix().c_str(), "");
+    PoolString<> prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "");
     command = "blink IsGroup (";
     interpreter.execute(command);
-    assertEqual(interpreter.get_prompt_prefix().c_str(), "(blink) ");
+    prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "(blink) ");
     interpreter.reset();
 
     command = "If (1) (";
     interpreter.execute(command);
-    assertEqual(interpreter.get_prompt_prefix().c_str(), "(IF) ");
+    prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "(IF) ");
     interpreter.reset();
 
     command = "Else (";
     interpreter.execute(command);
-    assertEqual(interpreter.get_prompt_prefix().c_str(), "(ELSE) ");
+    prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "(ELSE) ");
     interpreter.reset();
 
     Test::min_verbosity = prevTestVerbosity;
@@ -215,6 +220,106 @@ test(interpreter_execute_single_command)
     Test::min_verbosity = prevTestVerbosity;
 }
 
+test(interpreter_execute_temporaries)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test interpreter_execute_temporaries starting.");
+    interpreter.reset();
+    interpreter.execute(PoolString<>("a IsNumber(1)"));
+    interpreter.execute(PoolString<>("a IsNumber((a + 3) * 2 - a % 4)"));
+    int numStrings = get_stringpool(nullptr)->num_taken();
+    int numBlocks = get_alloc(nullptr)->num_taken();
+
+    // The temporaries of each command are all returned once it is done
+    for (int i = 0; i < 5; ++i) {
+        interpreter.execute(PoolString<>("a IsNumber((a + 3) * 2 - a % 4)"));
+        assertEqual(get_stringpool(nullptr)->num_taken(), numStrings, "i = " << i);
+        assertEqual(get_alloc(nullptr)->num_taken(), numBlocks, "i = " << i);
+    }
+    assertEqual(interpreter.get_number_value(PoolString<>("a")), 337);
+    interpreter.reset();
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_interning)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test interpreter_execute_interning starting.");
+    char const * commands[] = {
+        "counter IsGroup (",
+        "    If (number % 2 = 0) (",
+        "        number_even MoveBy(1)",
+        "    )",
+        "    number MoveBy(1)",
+        ")",
+        "number IsNumber(0)",
+        "number_even IsNumber(number + number - number - number)",
+        "counter RunGroup(10)",
+    };
+    int maxNumStrings[2];
+
+    // Names repeated within a command and across the group share one interned string
+    for (int interning = 0; interning < 2; ++interning) {
+        get_stringpool(nullptr)->set_interning(interning == 1);
+        interpreter.reset();
+        get_stringpool(nullptr)->reset_stat();
+        for (auto command : commands) {
+            interpreter.execute(PoolString<>(command));
+        }
+        maxNumStrings[interning] = get_stringpool(nullptr)->max_num_taken();
+        assertEqual(interpreter.get_number_value(PoolString<>("number")), 10);
+        assertEqual(interpreter.get_number_value(PoolString<>("number_even")), 5);
+    }
+    get_stringpool(nullptr)->set_interning(true);
+    interpreter.reset();
+    assertTrue(maxNumStrings[1] < maxNumStrings[0], maxNumStrings[1] << " " << maxNumStrings[0]);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_small_strings)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test interpreter_execute_small_strings starting.");
+    // The commands of examples/fizz_buzz_1.kitty
+    char const * commands[] = {
+        "fizzbuzz IsGroup (",
+        "    If (num % 3 = 0 & num % 5 = 0) (",
+        "        'FizzBuzz'",
+        "    )",
+        "    If (num % 3 = 0 & ~(num % 5 = 0)) (",
+        "        'Fizz'",
+        "    )",
+        "    If (~(num % 3 = 0) & num % 5 = 0) (",
+        "        'Buzz'",
+        "    ) ",
+        "    If (~(num % 3 = 0) & ~(num % 5 = 0)) (",
+        "        num",
+        "    )",
+        "    num MoveBy(1)",
+        ")",
+        "num IsNumber(1)",
+        "fizzbuzz RunGroup(20)",
+    };
+
+    // Names, numbers and operators are short enough to be kept out of the pool,
+    // which took 59 strings at once for this program before they were
+    interpreter.reset();
+    get_stringpool(nullptr)->reset_stat();
+    for (auto command : commands) {
+        interpreter.execute(PoolString<>(command));
+    }
+    assertEqual(interpreter.get_number_value(PoolString<>("num")), 21);
+    assertTrue(get_stringpool(nullptr)->max_num_taken() <= 30, get_stringpool(nullptr)->max_num_taken());
+    interpreter.reset();
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
 test(interpreter_execute_if)
 {
     int prevTestVerbosity = Test::min_verbosity;
@@ -466,6 +571,450 @@ test(interpreter_execute_group)
     Test::min_verbosity = prevTestVerbosity;
 }
 
+test(interpreter_execute_group_bindings)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_execute_group_bindings starting.");
+    interpreter.reset();
+    PoolString<> name("total");
+    Deque<PoolString<>> commands;
+
+    commands.push_back(PoolString<>("add_step IsGroup ("));
+    commands.push_back(PoolString<>("    total IsNumber(total + step)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("total IsNumber(0)"));
+    commands.push_back(PoolString<>("step IsNumber(2)"));
+    commands.push_back(PoolString<>("add_step RunGroup()"));
+    commands.push_back(PoolString<>("add_step RunGroup()"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 4);
+
+    // Names added after the group first ran are seen by the group
+    commands.clear();
+    commands.push_back(PoolString<>("other IsNumber(1)"));
+    commands.push_back(PoolString<>("step IsNumber(5)"));
+    commands.push_back(PoolString<>("add_step RunGroup()"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 9);
+
+    // Redefining the group binds its new names
+    commands.clear();
+    commands.push_back(PoolString<>("add_step IsGroup ("));
+    commands.push_back(PoolString<>("    total IsNumber(total + other)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("add_step RunGroup()"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 10);
+
+    // After a reset the group sees the names defined afresh
+    interpreter.reset();
+    commands.clear();
+    commands.push_back(PoolString<>("add_step IsGroup ("));
+    commands.push_back(PoolString<>("    total IsNumber(total + step)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("step IsNumber(3)"));
+    commands.push_back(PoolString<>("total IsNumber(1)"));
+    commands.push_back(PoolString<>("add_step RunGroup()"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 4);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_group_cursor)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_execute_group_cursor starting.");
+    interpreter.reset();
+    PoolString<> name("x");
+    Deque<PoolString<>> commands;
+
+    // Commands of an inner group run before the rest of the outer group
+    commands.push_back(PoolString<>("add_one IsGroup ("));
+    commands.push_back(PoolString<>("    x IsNumber(x + 1)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("shift IsGroup ("));
+    commands.push_back(PoolString<>("    x IsNumber(x * 10)"));
+    commands.push_back(PoolString<>("    If (x > 0) ("));
+    commands.push_back(PoolString<>("        add_one RunGroup(2)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    x IsNumber(x * 10)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("x IsNumber(1)"));
+    commands.push_back(PoolString<>("shift RunGroup(2)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 12020);
+
+    // Running a group more times takes no more memory at once
+    int blockSize = Sizes::slab_block_size_0;
+    interpreter.execute(PoolString<>("x IsNumber(0)"));
+    get_stringpool(nullptr)->reset_stat();
+    get_alloc(nullptr)->reset_stat();
+    interpreter.execute(PoolString<>("shift RunGroup(2)"));
+    int maxStrings = get_stringpool(nullptr)->max_num_taken();
+    int maxBlocks = get_alloc(nullptr)->max_num_taken(blockSize);
+    interpreter.execute(PoolString<>("x IsNumber(0)"));
+    get_stringpool(nullptr)->reset_stat();
+    get_alloc(nullptr)->reset_stat();
+    interpreter.execute(PoolString<>("shift RunGroup(50)"));
+    assertEqual(get_stringpool(nullptr)->max_num_taken(), maxStrings);
+    assertEqual(get_alloc(nullptr)->max_num_taken(blockSize), maxBlocks);
+
+    // Groups running inside each other stop at the limit
+    commands.clear();
+    commands.push_back(PoolString<>("x IsNumber(0)"));
+    commands.push_back(PoolString<>("nest IsGroup ("));
+    commands.push_back(PoolString<>("    nest RunGroup(1)"));
+    commands.push_back(PoolString<>("    x IsNumber(x + 1)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("nest RunGroup(1)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), Sizes::max_frame_depth);
+
+    // A group running itself from inside an if block takes two frames per level
+    commands.clear();
+    commands.push_back(PoolString<>("down IsGroup ("));
+    commands.push_back(PoolString<>("    If (x > 0) ("));
+    commands.push_back(PoolString<>("        x IsNumber(x - 1)"));
+    commands.push_back(PoolString<>("        down RunGroup(1)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>(")"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    int levels = Sizes::max_frame_depth / 2;
+    char command[32];
+    snprintf(command, sizeof(command), "x IsNumber(%d)", levels - 1);
+    interpreter.execute(PoolString<>(command));
+    interpreter.execute(PoolString<>("down RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 0);
+    snprintf(command, sizeof(command), "x IsNumber(%d)", levels + 5);
+    interpreter.execute(PoolString<>(command));
+    interpreter.execute(PoolString<>("down RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 5);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_redefine_kind)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_execute_redefine_kind starting.");
+    interpreter.reset();
+    PoolString<> name;
+    Deque<PoolString<>> commands;
+
+    // A name keeps its kind, and the error is printed instead
+    commands.push_back(PoolString<>("led IsLED(13, 50)"));
+    commands.push_back(PoolString<>("led IsNumber(3)"));
+    commands.push_back(PoolString<>("num IsNumber(4)"));
+    commands.push_back(PoolString<>("num IsLED(12, 20)"));
+    commands.push_back(PoolString<>("num IsGroup ("));
+    commands.push_back(PoolString<>("    led IsLED(13, 10)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("blink IsGroup ("));
+    commands.push_back(PoolString<>("    num IsNumber(5)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("blink IsNumber(6)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    name = "led";
+    assertTrue(interpreter.device_exists(name));
+    assertFalse(interpreter.number_exists(name));
+    assertEqual(interpreter.get_device_info(name, 2), 50);
+    name = "num";
+    assertTrue(interpreter.number_exists(name));
+    assertFalse(interpreter.device_exists(name));
+    assertFalse(interpreter.group_exists(name));
+    assertEqual(interpreter.get_number_value(name), 4);
+    name = "blink";
+    assertTrue(interpreter.group_exists(name));
+    assertFalse(interpreter.number_exists(name));
+
+    // The same name is still set again as its own kind
+    commands.clear();
+    commands.push_back(PoolString<>("led IsLED(13, 30)"));
+    commands.push_back(PoolString<>("num IsNumber(7)"));
+    commands.push_back(PoolString<>("blink RunGroup()"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    name = "led";
+    assertEqual(interpreter.get_device_info(name, 2), 30);
+    name = "num";
+    assertEqual(interpreter.get_number_value(name), 5);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_no_space)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_execute_no_space starting.");
+    interpreter.reset();
+    PoolString<> command;
+    PoolString<> name;
+
+    // Names past the size of the table are not created, and the error is printed instead
+    char letters[] = "aa";
+    for (int i = 0; i < Sizes::max_num_numbers + 2; ++i) {
+        letters[0] = 'a' + i / 26;
+        letters[1] = 'a' + i % 26;
+        command = letters;
+        command += " IsNumber(1)";
+        interpreter.execute(command);
+    }
+    name = "aa";
+    assertTrue(interpreter.number_exists(name));
+    name = letters;
+    assertFalse(interpreter.number_exists(name));
+    interpreter.execute(PoolString<>("aa MoveBy(1)"));
+    name = "aa";
+    assertEqual(interpreter.get_number_value(name), 2);
+    interpreter.reset();
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_frames)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_execute_frames starting.");
+    interpreter.reset();
+    PoolString<> name("y");
+    Deque<PoolString<>> commands;
+
+    // The if inside the inner group does not decide the else of the outer group
+    commands.push_back(PoolString<>("inner IsGroup ("));
+    commands.push_back(PoolString<>("    If (x > 100) ("));
+    commands.push_back(PoolString<>("        y IsNumber(1)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("outer IsGroup ("));
+    commands.push_back(PoolString<>("    If (x > 0) ("));
+    commands.push_back(PoolString<>("        inner RunGroup(1)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    Else ("));
+    commands.push_back(PoolString<>("        y IsNumber(2)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    y IsNumber(y * 10)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("x IsNumber(5)"));
+    commands.push_back(PoolString<>("y IsNumber(0)"));
+    commands.push_back(PoolString<>("outer RunGroup(1)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 0);
+    interpreter.execute(PoolString<>("x IsNumber(-5)"));
+    interpreter.execute(PoolString<>("outer RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 20);
+    interpreter.execute(PoolString<>("x IsNumber(500)"));
+    interpreter.execute(PoolString<>("outer RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 10);
+
+    // Blocks typed at the prompt run groups, and are followed by their else
+    commands.clear();
+    commands.push_back(PoolString<>("If (x < 0) ("));
+    commands.push_back(PoolString<>("    y IsNumber(3)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("Else ("));
+    commands.push_back(PoolString<>("    outer RunGroup(2)"));
+    commands.push_back(PoolString<>("    y IsNumber(y + 1)"));
+    commands.push_back(PoolString<>(")"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 11);
+    PoolString<> prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "");
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(interpreter_execute_blocks)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_execute_blocks starting.");
+    interpreter.reset();
+    PoolString<> name("y");
+    Deque<PoolString<>> commands;
+
+    // Blocks inside a group are run or skipped from where they end,
+    // including those with brackets inside strings
+    commands.push_back(PoolString<>("count IsGroup ("));
+    commands.push_back(PoolString<>("    If (x > 1) ("));
+    commands.push_back(PoolString<>("        If (x > 2) ("));
+    commands.push_back(PoolString<>("            'x > 2 ('"));
+    commands.push_back(PoolString<>("            y MoveBy(100)"));
+    commands.push_back(PoolString<>("        )"));
+    commands.push_back(PoolString<>("        Else ("));
+    commands.push_back(PoolString<>("            ')'"));
+    commands.push_back(PoolString<>("            y MoveBy(10)"));
+    commands.push_back(PoolString<>("        )"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    Else ("));
+    commands.push_back(PoolString<>("        y MoveBy(1)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    x MoveBy(-1)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("x IsNumber(4)"));
+    commands.push_back(PoolString<>("y IsNumber(0)"));
+    commands.push_back(PoolString<>("count RunGroup(4)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 211);
+    PoolString<> prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "");
+
+    // A group created by a running group keeps the ends of its own blocks
+    commands.clear();
+    commands.push_back(PoolString<>("make IsGroup ("));
+    commands.push_back(PoolString<>("    y IsNumber(0)"));
+    commands.push_back(PoolString<>("    If (1) ("));
+    commands.push_back(PoolString<>("        made IsGroup ("));
+    commands.push_back(PoolString<>("            If (x = 0) ("));
+    commands.push_back(PoolString<>("                y MoveBy(1)"));
+    commands.push_back(PoolString<>("            )"));
+    commands.push_back(PoolString<>("            Else ("));
+    commands.push_back(PoolString<>("                y MoveBy(10)"));
+    commands.push_back(PoolString<>("            )"));
+    commands.push_back(PoolString<>("        )"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    made RunGroup(2)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("make RunGroup(1)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 2);
+    assertEqual(interpreter.get_group_commands(PoolString<>("made")).size(), 6);
+    interpreter.execute(PoolString<>("x IsNumber(1)"));
+    interpreter.execute(PoolString<>("made RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 12);
+
+    // A group can create itself again while it runs
+    commands.clear();
+    commands.push_back(PoolString<>("again IsGroup ("));
+    commands.push_back(PoolString<>("    again IsGroup ("));
+    commands.push_back(PoolString<>("        y MoveBy(1000)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("again RunGroup(1)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 12);
+    interpreter.execute(PoolString<>("again RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 1012);
+    assertEqual(interpreter.get_group_commands(PoolString<>("again")).size(), 1);
+    prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "");
+
+    // The rest of the old commands still run, and the new commands run the next time
+    commands.clear();
+    commands.push_back(PoolString<>("y IsNumber(0)"));
+    commands.push_back(PoolString<>("twice IsGroup ("));
+    commands.push_back(PoolString<>("    y MoveBy(1)"));
+    commands.push_back(PoolString<>("    twice IsGroup ("));
+    commands.push_back(PoolString<>("        y MoveBy(1000)"));
+    commands.push_back(PoolString<>("        y MoveBy(2000)"));
+    commands.push_back(PoolString<>("        y MoveBy(4000)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    y MoveBy(10)"));
+    commands.push_back(PoolString<>("    If (y > 0) ("));
+    commands.push_back(PoolString<>("        y MoveBy(100)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("twice RunGroup(1)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 111);
+    assertEqual(interpreter.get_group_commands(PoolString<>("twice")).size(), 3);
+    interpreter.execute(PoolString<>("twice RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 7111);
+
+    commands.clear();
+    commands.push_back(PoolString<>("y IsNumber(0)"));
+    commands.push_back(PoolString<>("twice IsGroup ("));
+    commands.push_back(PoolString<>("    y MoveBy(1)"));
+    commands.push_back(PoolString<>("    twice IsGroup ("));
+    commands.push_back(PoolString<>("        y MoveBy(1000)"));
+    commands.push_back(PoolString<>("    )"));
+    commands.push_back(PoolString<>("    y MoveBy(10)"));
+    commands.push_back(PoolString<>("    y MoveBy(100)"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("twice RunGroup(3)"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 2111);
+    prefix = interpreter.get_prompt_prefix();
+    assertEqual(prefix.c_str(), "");
+
+    // The old commands are released once they stop running
+    for (int i = 0; i < 20; ++i) {
+        interpreter.execute(PoolString<>("twice IsGroup ("));
+        interpreter.execute(PoolString<>("    twice IsGroup ("));
+        interpreter.execute(PoolString<>("    )"));
+        interpreter.execute(PoolString<>(")"));
+        interpreter.execute(PoolString<>("twice RunGroup(2)"));
+    }
+    assertEqual(interpreter.get_group_commands(PoolString<>("twice")).size(), 0);
+    interpreter.execute(PoolString<>("other IsGroup ("));
+    interpreter.execute(PoolString<>("    y MoveBy(1)"));
+    interpreter.execute(PoolString<>(")"));
+    interpreter.execute(PoolString<>("other RunGroup(1)"));
+    assertEqual(interpreter.get_number_value(name), 2112);
+
+    // The old commands are not released while the code of the last of them still runs
+    interpreter.reset();
+    commands.clear();
+    commands.push_back(PoolString<>("y IsNumber(0)"));
+    commands.push_back(PoolString<>("aa IsGroup ("));
+    commands.push_back(PoolString<>("    aa IsGroup ("));
+    commands.push_back(PoolString<>("        y MoveBy(1000)"));
+    commands.push_back(PoolString<>("    )"));
+    for (int i = 0; i < 6; ++i) {
+        commands.push_back(PoolString<>("    Wait(0)"));
+    }
+    commands.push_back(PoolString<>("    bb RunGroup()"));
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("bb IsGroup ("));
+    for (int i = 0; i < 12; ++i) {
+        commands.push_back(PoolString<>("    y MoveBy(1)"));
+    }
+    commands.push_back(PoolString<>(")"));
+    commands.push_back(PoolString<>("aa RunGroup()"));
+    for (auto & command : commands) {
+        interpreter.execute(command);
+    }
+    assertEqual(interpreter.get_number_value(name), 12);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
 test(interpreter_fizz_buzz)
 {
     int prevTestVerbosity = Test::min_verbosity;
@@ -608,3 +1157,82 @@ test(interpreter_fizz_buzz)
 
     Test::min_verbosity = prevTestVerbosity;
 }
+
+test(interpreter_evaluate_nested)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test interpreter_evaluate_nested starting.");
+    interpreter.reset();
+    PoolString<> name("x");
+    Tokenizer<> tokenizer;
+    Parser<> parser;
+    Compiler<> compiler;
+    unsigned char code[Sizes::max_code_length];
+    int blockSizes[] = {Sizes::slab_block_size_0, Sizes::slab_block_size_1, Sizes::slab_block_size_2, Sizes::slab_block_size_3};
+
+    // Every value but the innermost waits on the stack for the ones inside it
+    int depth = Sizes::max_eval_depth - 1 < 20 ? Sizes::max_eval_depth - 1 : 20;
+    PoolString<> command("x IsNumber(");
+    for (int i = 0; i < depth; ++i) {
+        command += "1+(";
+    }
+    command += "x";
+    for (int i = 0; i < depth; ++i) {
+        command += ")";
+    }
+    command += ")";
+    int len = compiler.compile(parser.parse(tokenizer.tokenize(command)));
+    assertTrue(len > 0);
+    memcpy(code, compiler.code(), len);
+
+    interpreter.execute(PoolString<>("x IsNumber(1)"));
+    interpreter.run_code(code);
+    assertEqual(interpreter.get_number_value(name), 1 + depth);
+
+    // Once the names are bound, evaluating takes no strings or blocks at all
+    int numStrings = get_stringpool(nullptr)->num_taken();
+    int numBlocks[4];
+    for (int i = 0; i < 4; ++i) {
+        numBlocks[i] = get_alloc(nullptr)->num_taken(blockSizes[i]);
+    }
+    get_stringpool(nullptr)->reset_stat();
+    get_alloc(nullptr)->reset_stat();
+    for (int i = 0; i < 10; ++i) {
+        interpreter.run_code(code);
+    }
+    assertEqual(interpreter.get_number_value(name), 1 + 11 * depth);
+    assertEqual(get_stringpool(nullptr)->max_num_taken(), numStrings);
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(get_alloc(nullptr)->max_num_taken(blockSizes[i]), numBlocks[i], "i = " << i);
+    }
+
+    // Nesting the other way keeps the stack short, however deep it goes
+    command = "x IsNumber(";
+    for (int i = 0; i < depth; ++i) {
+        command += "(";
+    }
+    command += "x";
+    for (int i = 0; i < depth; ++i) {
+        command += "*2-x)";
+    }
+    command += ")";
+    len = compiler.compile(parser.parse(tokenizer.tokenize(command)));
+    assertTrue(len > 0);
+    memcpy(code, compiler.code(), len);
+    interpreter.execute(PoolString<>("x IsNumber(3)"));
+    numStrings = get_stringpool(nullptr)->num_taken();
+    for (int i = 0; i < 4; ++i) {
+        numBlocks[i] = get_alloc(nullptr)->num_taken(blockSizes[i]);
+    }
+    get_stringpool(nullptr)->reset_stat();
+    get_alloc(nullptr)->reset_stat();
+    interpreter.run_code(code);
+    assertEqual(interpreter.get_number_value(name), 3);
+    assertEqual(get_stringpool(nullptr)->max_num_taken(), numStrings);
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(get_alloc(nullptr)->max_num_taken(blockSizes[i]), numBlocks[i], "i = " << i);
+    }
+
+    Test::min_verbosity = prevTestVerbosity;
+}
@@ -107,3 +107,145 @@ test(machine_state_group)
 
     Test::min_verbosity = prevTestVerbosity;
 }
+
+test(machine_state_new_group)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test machine_state_new_group starting.");
+    PoolString<> name("blink");
+    unsigned char code[] = {1, 2, 3};
+    machineState.reset();
+
+    // Nothing is added before a new group is begun
+    assertEqual(machineState.add_to_new_group(PoolString<>("light")), -1);
+    assertFalse(machineState.set_new_group(name));
+
+    assertTrue(machineState.begin_new_group());
+    assertEqual(machineState.add_to_new_group(PoolString<>("light MoveBy(1)"), code, 2), 0);
+    assertEqual(machineState.add_to_new_group(PoolString<>("light")), 1);
+    assertEqual(machineState.get_new_group_code(0)[1], 2);
+    assertTrue(machineState.get_new_group_code(1) == nullptr);
+    assertFalse(machineState.group_exists(name));
+    assertTrue(machineState.set_new_group(name));
+    assertTrue(machineState.group_exists(name));
+    Symbol symbol = machineState.lookup(name);
+    assertEqual(machineState.get_group_size(symbol), 2);
+    assertEqual(machineState.get_group_code(symbol, 0)[0], 1);
+
+    // A group is only changed once its new commands are finished
+    assertTrue(machineState.begin_new_group());
+    assertEqual(machineState.copy_to_new_group(symbol, 1), 0);
+    assertEqual(machineState.copy_to_new_group(symbol, 0), 1);
+    assertEqual(machineState.copy_to_new_group(symbol, 2), -1);
+    assertEqual(machineState.get_group_size(symbol), 2);
+    PoolString<> command = machineState.get_group_command(symbol, 0);
+    assertEqual(command.c_str(), "light MoveBy(1)");
+    assertTrue(machineState.set_new_group(name));
+    assertEqual(machineState.get_group_size(symbol), 2);
+    command = machineState.get_group_command(symbol, 0);
+    assertEqual(command.c_str(), "light");
+    command = machineState.get_group_command(symbol, 1);
+    assertEqual(command.c_str(), "light MoveBy(1)");
+    assertEqual(machineState.get_group_code(symbol, 1)[1], 2);
+
+    // An unfinished group is dropped when another is begun
+    assertTrue(machineState.begin_new_group());
+    assertEqual(machineState.add_to_new_group(PoolString<>("dropped")), 0);
+    assertTrue(machineState.begin_new_group());
+    assertTrue(machineState.set_new_group(name));
+    assertEqual(machineState.get_group_size(symbol), 0);
+
+    // A name that is not a group is left as it is
+    machineState.set_number(PoolString<>("num"), 1);
+    assertTrue(machineState.begin_new_group());
+    assertFalse(machineState.set_new_group(PoolString<>("num")));
+    assertTrue(machineState.number_exists(PoolString<>("num")));
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(machine_state_many_names)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test machine_state_many_names starting.");
+    char name[8];
+    machineState.reset();
+    for (int i = 0; i < Sizes::max_num_numbers; ++i) {
+        snprintf(name, sizeof(name), "n%d", i);
+        assertTrue(machineState.set_number(PoolString<>(name), i), "i = " << i);
+    }
+    assertFalse(machineState.set_number(PoolString<>("extra"), 0));
+    for (int i = 0; i < Sizes::max_num_numbers; ++i) {
+        snprintf(name, sizeof(name), "n%d", i);
+        assertEqual(machineState.get_number_value(PoolString<>(name)), i, "i = " << i);
+    }
+
+    // Groups keep their commands when other groups are added or set again
+    Deque<PoolString<>> commands;
+    for (int i = 0; i < 3; ++i) {
+        snprintf(name, sizeof(name), "g%d", i);
+        commands.clear();
+        commands.push_back(PoolString<>(name));
+        assertTrue(machineState.set_group(PoolString<>(name), commands), "i = " << i);
+    }
+    commands.push_back(PoolString<>("again"));
+    assertTrue(machineState.set_group(PoolString<>("g0"), commands));
+    assertEqual(machineState.get_group_commands(PoolString<>("g0")).size(), 2);
+    assertEqual(machineState.get_group_commands(PoolString<>("g1"))[0].c_str(), "g1");
+    assertEqual(machineState.get_group_commands(PoolString<>("g2"))[0].c_str(), "g2");
+
+    machineState.reset();
+    assertFalse(machineState.number_exists(PoolString<>("n0")));
+    assertFalse(machineState.group_exists(PoolString<>("g0")));
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(machine_state_lookup)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test machine_state_lookup starting.");
+    PoolString<> number("count");
+    PoolString<> device("light");
+    PoolString<> group("blink");
+    Deque<PoolString<>> commands;
+    commands.push_back(PoolString<>("count MoveBy(1)"));
+    machineState.reset();
+    assertFalse(machineState.lookup(number).exists());
+    assertEqual(machineState.lookup(number).slot(), -1);
+
+    assertTrue(machineState.set_number(number, 3));
+    assertTrue(machineState.set_device(device, DeviceType::LED, -1, 13, 50));
+    assertTrue(machineState.set_group(group, commands));
+
+    // Each name refers to one kind of thing, read and written through its handle
+    Symbol symbol = machineState.lookup(number);
+    assertEqual(symbol.kind(), SymbolKind::NUMBER_SYMBOL);
+    assertEqual(machineState.get_number_value(symbol), 3);
+    assertTrue(machineState.set_number(symbol, 4));
+    assertEqual(machineState.get_number_value(number), 4);
+    assertFalse(machineState.set_device(symbol, DeviceType::LED, -1, 13, 0));
+    assertEqual(machineState.get_device_info(symbol, 2), -1);
+
+    symbol = machineState.lookup(device);
+    assertTrue(symbol.is_device());
+    assertTrue(machineState.set_device(symbol, DeviceType::LED, -1, 13, 75));
+    assertEqual(machineState.get_device_info(device, 2), 75);
+    assertFalse(machineState.set_number(symbol, 1));
+    assertEqual(machineState.get_number_value(symbol), 0);
+
+    symbol = machineState.lookup(group);
+    assertTrue(symbol.is_group());
+    assertEqual(machineState.get_group_commands(symbol).size(), 1);
+
+    // A name cannot be taken by another kind of thing
+    assertFalse(machineState.set_number(device, 1));
+    assertFalse(machineState.set_group(number, commands));
+    assertTrue(machineState.lookup(device).is_device());
+    assertTrue(machineState.lookup(number).is_number());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
@@ -262,7 +262,9 @@ void parser_check_tokens_match(Deque<Token<>> & generatedTokens,
     int i = 0;
     while (genIter != generatedTokens.end() && expIter != expectedTokens.end()) {
         assertEqual(genIter->get_type(), expIter->get_type(), "i = " << i << ": " << comment);
-        assertEqual(genIter->get_value().c_str(), expIter->get_value().c_str(), "i = " << i << ": " << comment);
+        PoolString<> genValue = genIter->get_value();
+        PoolString<> expValue = expIter->get_value();
+        assertEqual(genValue.c_str(), expValue.c_str(), "i = " << i << ": " << comment);
         ++genIter;
         ++expIter;
         ++i;
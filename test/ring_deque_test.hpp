@@ -0,0 +1,123 @@
+#pragma once
+
+#include <kty/containers/ring_deque.hpp>
+#include <kty/containers/string.hpp>
+#include <kty/containers/stringpool.hpp>
+
+using namespace kty;
+
+test(ring_deque_front) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test ring_deque_front starting.");
+    const int numInts = 10;
+    RingDeque<int, numInts> deque;
+    assertEqual(deque.capacity(), numInts);
+    for (int i = 0; i < numInts; ++i) {
+        assertTrue(deque.push_front(i), "i = " << i);
+        assertEqual(deque.size(), i + 1, "i = " << i);
+    }
+    assertTrue(deque.is_full());
+    assertFalse(deque.push_front(0));
+    assertFalse(deque.push_back(0));
+
+    for (int i = 0; i < numInts; ++i) {
+        assertEqual(deque.front(), numInts - 1 - i, "i = " << i);
+        assertTrue(deque.pop_front(), "i = " << i);
+        assertEqual(deque.size(), numInts - 1 - i, "i = " << i);
+    }
+    assertTrue(deque.is_empty());
+    assertFalse(deque.pop_front());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(ring_deque_back) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test ring_deque_back starting.");
+    const int numInts = 10;
+    RingDeque<int, numInts> deque;
+    for (int i = 0; i < numInts; ++i) {
+        assertTrue(deque.push_back(i), "i = " << i);
+        assertEqual(deque.size(), i + 1, "i = " << i);
+    }
+    assertFalse(deque.push_back(0));
+
+    for (int i = 0; i < numInts; ++i) {
+        assertEqual(deque.back(), numInts - 1 - i, "i = " << i);
+        assertTrue(deque.pop_back(), "i = " << i);
+        assertEqual(deque.size(), numInts - 1 - i, "i = " << i);
+    }
+    assertFalse(deque.pop_back());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(ring_deque_wrap_around_and_access) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test ring_deque_wrap_around_and_access starting.");
+    RingDeque<int, 4> deque;
+
+    // Values wrap around the end of the buffer in both directions
+    deque.push_back(2);
+    deque.push_back(3);
+    deque.push_front(1);
+    deque.push_front(0);
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(deque[i], i, "i = " << i);
+    }
+    deque.pop_front();
+    deque.pop_front();
+    deque.push_back(4);
+    deque.push_back(5);
+    for (int i = 0; i < 4; ++i) {
+        assertEqual(deque[i], i + 2, "i = " << i);
+    }
+    deque[1] = 7;
+    assertEqual(deque[1], 7);
+
+    int expected[] = {2, 7, 4, 5};
+    int i = 0;
+    for (RingDeque<int, 4>::Iterator it = deque.begin(); it != deque.end(); ++it, ++i) {
+        assertEqual(*it, expected[i], "i = " << i);
+    }
+    assertEqual(i, 4);
+    RingDeque<int, 4> const & constDeque = deque;
+    i = 0;
+    for (RingDeque<int, 4>::ConstIterator it = constDeque.cbegin(); it != constDeque.cend(); ++it, ++i) {
+        assertEqual(*it, expected[i], "i = " << i);
+    }
+
+    deque.clear();
+    assertEqual(deque.size(), 0);
+    assertTrue(deque.begin() == deque.end());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+/** A pool of another size, which the strings of the deque are told of at compile time */
+StringPool<5, 8> ringDequeStringPool;
+
+test(ring_deque_releases_values) {
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test ring_deque_releases_values starting.");
+    StringPool<5, 8> & stringPool = ringDequeStringPool;
+    typedef PoolString<StringPool<5, 8>, StaticPool<StringPool<5, 8>, &ringDequeStringPool>> SmallString;
+    RingDeque<SmallString, 4> deque;
+    SmallString string(stringPool, "goodbye");
+
+    // Popped values are reset, so their pool indices are given back straight away
+    deque.push_back(string);
+    deque.push_back(SmallString(stringPool, "farewell"));
+    assertEqual(stringPool.available(), 3);
+    deque.pop_back();
+    assertEqual(stringPool.available(), 4);
+    deque.pop_front();
+    assertEqual(stringPool.ref_count(string.pool_idx()), 1);
+    assertEqual(string.c_str(), "goodbye");
+
+    Test::min_verbosity = prevTestVerbosity;
+}
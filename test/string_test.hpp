@@ -173,6 +173,13 @@ test(string_strlen)
 
     string.strcat("hi");
     assertEqual(string.strlen(), 7);
+
+    string[3] = '\0';
+    assertEqual(string.strlen(), 3);
+
+    string.insert("p!", 3);
+    assertEqual(string.c_str(), "help!");
+    assertEqual(string.strlen(), 5);
     
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -202,13 +209,18 @@ test(string_add_operator)
     Serial.println("Test string_add_operator starting.");
     PoolString<> string1;
     assertEqual(string1.c_str(), "");
-    assertEqual((string1 + "hello").c_str(), "hello");
+    PoolString<> result = string1 + "hello";
+    assertEqual(result.c_str(), "hello");
 
     PoolString<> string2("hello");
-    assertEqual((string1 + string2).c_str(), string2.c_str());
-    assertEqual((string1 + string2).c_str(), "hello");
-    assertEqual((string2 + string1).c_str(), string2.c_str());
-    assertEqual((string2 + string1).c_str(), "hello");
+    result = string1 + string2;
+    assertEqual(result.c_str(), string2.c_str());
+    result = string1 + string2;
+    assertEqual(result.c_str(), "hello");
+    result = string2 + string1;
+    assertEqual(result.c_str(), string2.c_str());
+    result = string2 + string1;
+    assertEqual(result.c_str(), "hello");
     
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -336,13 +348,19 @@ test(string_substr_il)
     Serial.println("Test string_substr_il starting.");
     const PoolString<> string("1234567890");
 
-    assertEqual(string.substr_il().c_str(), "1234567890");
-    assertEqual(string.substr_il(0).c_str(), "1234567890");
-    assertEqual(string.substr_il(0, 10).c_str(), "1234567890");
+    PoolString<> result = string.substr_il();
+    assertEqual(result.c_str(), "1234567890");
+    result = string.substr_il(0);
+    assertEqual(result.c_str(), "1234567890");
+    result = string.substr_il(0, 10);
+    assertEqual(result.c_str(), "1234567890");
 
-    assertEqual(string.substr_il(2).c_str(), "34567890");    
-    assertEqual(string.substr_il(2, 8).c_str(), "34567890");    
-    assertEqual(string.substr_il(2, 6).c_str(), "345678");    
+    result = string.substr_il(2);
+    assertEqual(result.c_str(), "34567890");
+    result = string.substr_il(2, 8);
+    assertEqual(result.c_str(), "34567890");
+    result = string.substr_il(2, 6);
+    assertEqual(result.c_str(), "345678");
 
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -354,13 +372,212 @@ test(string_substr_ii)
     Serial.println("Test string_substr_ii starting.");
     const PoolString<> string("1234567890");
 
-    assertEqual(string.substr_ii().c_str(), "1234567890");
-    assertEqual(string.substr_ii(0).c_str(), "1234567890");
-    assertEqual(string.substr_ii(0, 10).c_str(), "1234567890");
+    PoolString<> result = string.substr_ii();
+    assertEqual(result.c_str(), "1234567890");
+    result = string.substr_ii(0);
+    assertEqual(result.c_str(), "1234567890");
+    result = string.substr_ii(0, 10);
+    assertEqual(result.c_str(), "1234567890");
+
+    result = string.substr_ii(2);
+    assertEqual(result.c_str(), "34567890");
+    result = string.substr_ii(2, 8);
+    assertEqual(result.c_str(), "345678");
+    result = string.substr_ii(2, 6);
+    assertEqual(result.c_str(), "3456");
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(string_intern)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_intern starting.");
+    StringPool<5, 8> stringPool;
+    PoolString<decltype(stringPool)> string1(stringPool, "goodbye");
+    PoolString<decltype(stringPool)> string2(stringPool, "goodbye");
+    assertFalse(string1.is_interned());
+    assertNotEqual(string1.pool_idx(), string2.pool_idx());
+
+    string1.intern();
+    string2.intern();
+    assertTrue(string1.is_interned());
+    assertEqual(string1.pool_idx(), string2.pool_idx());
+    assertTrue(string1 == string2);
+    assertEqual(stringPool.available(), 4);
+
+    // Copies share the interned index
+    PoolString<decltype(stringPool)> string3(string1);
+    assertEqual(string3.pool_idx(), string1.pool_idx());
+    assertEqual(stringPool.ref_count(string1.pool_idx()), 3);
+
+    // Modifying an interned string leaves the others untouched
+    string3 += "!";
+    assertFalse(string3.is_interned());
+    assertNotEqual(string3.pool_idx(), string1.pool_idx());
+    assertEqual(string3.c_str(), "goodbye!");
+    string2[0] = 'j';
+    assertEqual(string2.c_str(), "joodbye");
+    assertEqual(string1.c_str(), "goodbye");
+    assertFalse(string1 == string2);
+    
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(string_copy_on_write)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_copy_on_write starting.");
+    StringPool<5, 8> stringPool;
+    PoolString<decltype(stringPool)> string1(stringPool, "goodbye");
+    assertEqual(stringPool.available(), 4);
+
+    // Copies share the index until they are modified
+    PoolString<decltype(stringPool)> string2(string1);
+    PoolString<decltype(stringPool)> string3(stringPool);
+    string3 = string1;
+    assertEqual(string2.pool_idx(), string1.pool_idx());
+    assertEqual(string3.pool_idx(), string1.pool_idx());
+    assertEqual(stringPool.ref_count(string1.pool_idx()), 3);
+    assertEqual(stringPool.available(), 4);
+
+    string2 += "!";
+    assertNotEqual(string2.pool_idx(), string1.pool_idx());
+    assertEqual(string2.c_str(), "goodbye!");
+    string3[0] = 'j';
+    assertEqual(string3.c_str(), "joodbye");
+    string1.insert("y", 7);
+    assertEqual(string1.c_str(), "goodbyey");
+    assertEqual(stringPool.available(), 2);
+
+    // Overwriting a shared string does not copy it first
+    PoolString<decltype(stringPool)> string4(string1);
+    string4 = "bye";
+    assertEqual(string4.c_str(), "bye");
+    assertEqual(string1.c_str(), "goodbyey");
+    assertEqual(stringPool.ref_count(string1.pool_idx()), 1);
+
+    // Assigning a string that already shares the index keeps it alive
+    string4 = string1;
+    string4 = string1;
+    assertEqual(stringPool.ref_count(string1.pool_idx()), 2);
+    assertEqual(string4.c_str(), "goodbyey");
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(string_move)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_move starting.");
+    StringPool<5, 8> stringPool;
+    PoolString<decltype(stringPool)> string1(stringPool, "goodbye");
+    int idx = string1.pool_idx();
+
+    // Moving takes over the index without touching its reference count
+    PoolString<decltype(stringPool)> string2(move(string1));
+    assertEqual(string2.pool_idx(), idx);
+    assertEqual(string1.pool_idx(), -1);
+    assertEqual(stringPool.ref_count(idx), 1);
+    assertEqual(stringPool.available(), 4);
+
+    PoolString<decltype(stringPool)> string3(stringPool, "bye");
+    string3 = move(string2);
+    assertEqual(string3.pool_idx(), idx);
+    assertEqual(string3.c_str(), "goodbye");
+    assertEqual(stringPool.available(), 4);
+
+    // A moved from string is left empty, and only gets a new index for a long string
+    string1 = "farewell";
+    string2 += "!";
+    assertEqual(string1.c_str(), "farewell");
+    assertEqual(string2.c_str(), "!");
+    assertEqual(string2.pool_idx(), -1);
+    assertEqual(stringPool.available(), 3);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(string_small)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_small starting.");
+    StringPool<5, 8> stringPool;
+    PoolString<decltype(stringPool)> string1(stringPool, "num");
+    PoolString<decltype(stringPool)> string2(string1);
+    PoolString<decltype(stringPool)> string3(stringPool);
+
+    // Short strings are stored inside the object, without taking an index
+    assertEqual(string1.pool_idx(), -1);
+    assertEqual(string2.pool_idx(), -1);
+    assertEqual(string3.pool_idx(), -1);
+    assertEqual(string3.c_str(), "");
+    assertEqual(stringPool.available(), 5);
+    string2[0] = 'b';
+    string1.intern();
+    assertFalse(string1.is_interned());
+    assertEqual(string1.c_str(), "num");
+    assertEqual(string2.c_str(), "bum");
+    assertEqual(string1.strlen(), 3);
+    assertTrue(string1 == PoolString<decltype(stringPool)>(stringPool, "num"));
+
+    // Growing past the inline length moves the string into the pool
+    string1 += "_e";
+    assertEqual(string1.pool_idx(), -1);
+    string1 += "ven";
+    assertEqual(string1.c_str(), "num_even");
+    assertNotEqual(string1.pool_idx(), -1);
+    assertEqual(string1.strlen(), 8);
+    assertEqual(stringPool.available(), 4);
+
+    // A string appended to itself is read before it is moved into the pool
+    string2 += string2;
+    assertEqual(string2.c_str(), "bumbum");
+    assertEqual(stringPool.available(), 3);
+
+    // Shrinking back gives the index up again
+    string1 = string1.substr_ii(0, 3);
+    assertEqual(string1.c_str(), "num");
+    assertEqual(string1.pool_idx(), -1);
+    assertEqual(stringPool.available(), 4);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
 
-    assertEqual(string.substr_ii(2).c_str(), "34567890");    
-    assertEqual(string.substr_ii(2, 8).c_str(), "345678");    
-    assertEqual(string.substr_ii(2, 6).c_str(), "3456");    
+test(string_static_pool)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_static_pool starting.");
+    typedef PoolString<StringPool<>, StaticPool<StringPool<>, &stringPool>> StaticString;
+    int numTaken = stringPool.num_taken();
+    {
+        // The pool is named by the type, so the string holds no pointers to it
+        assertTrue(sizeof(StaticString) < sizeof(PoolString<>));
+        assertTrue(sizeof(StaticString) <= Sizes::small_string_length + 1 + 2 * sizeof(int));
+
+        StaticString string1("num");
+        StaticString string2("a_longer_name");
+        StaticString string3(string2);
+        assertEqual(string1.pool_idx(), -1);
+        assertNotEqual(string2.pool_idx(), -1);
+        assertEqual(string3.pool_idx(), string2.pool_idx());
+        assertEqual(stringPool.num_taken(), numTaken + 1);
+
+        string3 += "_too";
+        assertEqual(string2.c_str(), "a_longer_name");
+        assertEqual(string3.c_str(), "a_longer_name_too");
+        assertEqual(string3.strlen(), 17);
+        assertEqual(stringPool.num_taken(), numTaken + 2);
+        string1 = move(string3);
+        assertEqual(string1.c_str(), "a_longer_name_too");
+        assertEqual(string3.c_str(), "");
+    }
+    assertEqual(stringPool.num_taken(), numTaken);
 
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -40,6 +40,11 @@ test(string_utils_str_to_int)
     str = "-12345";
     assertEqual(str_to_int(str), -12345);
 
+    // Only the characters of a view are converted
+    assertEqual(str_to_int(StringView("1234", 2)), 12);
+    assertEqual(str_to_int(StringView("-1x", 2)), -1);
+    assertEqual(str_to_int(StringView("1x", 2)), 0);
+
     Test::min_verbosity = prevTestVerbosity;
 }
 
@@ -48,16 +53,26 @@ test(string_utils_int_to_str)
     int prevTestVerbosity = Test::min_verbosity;
 
     Serial.println("Test string_utils_int_to_str starting.");
-    assertEqual(int_to_str(1, stringPool).c_str(), "1");
-    assertEqual(int_to_str(12, stringPool).c_str(), "12");
-    assertEqual(int_to_str(123, stringPool).c_str(), "123");
-    assertEqual(int_to_str(1234, stringPool).c_str(), "1234");
-    assertEqual(int_to_str(12345, stringPool).c_str(), "12345");
-    assertEqual(int_to_str(-1, stringPool).c_str(), "-1");
-    assertEqual(int_to_str(-12, stringPool).c_str(), "-12");
-    assertEqual(int_to_str(-123, stringPool).c_str(), "-123");
-    assertEqual(int_to_str(-1234, stringPool).c_str(), "-1234");
-    assertEqual(int_to_str(-12345, stringPool).c_str(), "-12345");
+    PoolString<> str = int_to_str(1, stringPool);
+    assertEqual(str.c_str(), "1");
+    str = int_to_str(12, stringPool);
+    assertEqual(str.c_str(), "12");
+    str = int_to_str(123, stringPool);
+    assertEqual(str.c_str(), "123");
+    str = int_to_str(1234, stringPool);
+    assertEqual(str.c_str(), "1234");
+    str = int_to_str(12345, stringPool);
+    assertEqual(str.c_str(), "12345");
+    str = int_to_str(-1, stringPool);
+    assertEqual(str.c_str(), "-1");
+    str = int_to_str(-12, stringPool);
+    assertEqual(str.c_str(), "-12");
+    str = int_to_str(-123, stringPool);
+    assertEqual(str.c_str(), "-123");
+    str = int_to_str(-1234, stringPool);
+    assertEqual(str.c_str(), "-1234");
+    str = int_to_str(-12345, stringPool);
+    assertEqual(str.c_str(), "-12345");
 
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <kty/containers/string.hpp>
+#include <kty/containers/string_view.hpp>
+#include <kty/containers/stringpool.hpp>
+
+using namespace kty;
+
+test(string_view_constructors)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_view_constructors starting.");
+    StringView view1;
+    assertEqual(view1.strlen(), 0);
+    assertTrue(view1 == "");
+
+    StringView view2("hello world", 5);
+    assertEqual(view2.strlen(), 5);
+    assertTrue(view2 == "hello");
+
+    StringView view3("hello");
+    assertEqual(view3.strlen(), 5);
+    assertTrue(view3 == "hello");
+
+    PoolString<> string("hello world");
+    StringView view4(string);
+    assertEqual(view4.strlen(), 11);
+    assertTrue(view4.data() == string.c_str());
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(string_view_compare_and_find)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_view_compare_and_find starting.");
+    StringView view("num IsNumber(1)", 12);
+
+    assertFalse(view == "num");
+    assertFalse(view == "num IsNumber(1)");
+    assertTrue(view == "num IsNumber");
+
+    assertTrue(view.starts_with("num"));
+    assertTrue(view.starts_with("IsNumber", 4));
+    assertFalse(view.starts_with("IsNumber(", 4));
+    assertFalse(view.starts_with("IsLED", 4));
+
+    assertEqual(view.find('I'), 4);
+    assertEqual(view.find('u', 2), 7);
+    assertEqual(view.find('('), -1);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(string_view_substr_ii)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test string_view_substr_ii starting.");
+    StringView view("1234567890");
+
+    assertTrue(view.substr_ii() == "1234567890");
+    assertTrue(view.substr_ii(2) == "34567890");
+    assertTrue(view.substr_ii(2, 6) == "3456");
+    assertTrue(view.substr_ii(2, 20) == "34567890");
+    assertTrue(view.substr_ii(6, 2) == "");
+
+    // Pool strings copy only the characters of a view
+    PoolString<> string1;
+    string1 = view.substr_ii(1, 3);
+    assertEqual(string1.c_str(), "23");
+    assertEqual(string1.strlen(), 2);
+    string1 = view.substr_ii(1, 9);
+    assertEqual(string1.c_str(), "23456789");
+    assertEqual(string1.strlen(), 8);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
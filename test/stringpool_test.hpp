@@ -98,3 +98,173 @@ test(stringpool_allocate_deallocate_idx)
 
     Test::min_verbosity = prevTestVerbosity;    
 }
+
+test(stringpool_free_list)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test stringpool_free_list starting.");
+    const int numStrings = 5;
+    StringPool<numStrings, 1> stringPool;
+
+    for (int i = 0; i < numStrings; ++i) {
+        assertEqual(stringPool.allocate_idx(), i);
+    }
+    assertEqual(stringPool.available(), 0);
+
+    // A freed index from the middle of the pool is handed out next
+    assertTrue(stringPool.deallocate_idx(2));
+    assertEqual(stringPool.available(), 1);
+    assertEqual(stringPool.allocate_idx(), 2);
+    assertEqual(stringPool.allocate_idx(), -1);
+
+    // Decreasing the reference count to 0 returns the index to the pool
+    assertEqual(stringPool.dec_ref_count(4), 0);
+    assertEqual(stringPool.dec_ref_count(4), 0);
+    assertEqual(stringPool.available(), 1);
+
+    // Increasing the reference count of a free index takes it out of the pool
+    assertTrue(stringPool.deallocate_idx(0));
+    assertEqual(stringPool.inc_ref_count(4), 1);
+    assertEqual(stringPool.available(), 1);
+    assertEqual(stringPool.allocate_idx(), 0);
+    assertEqual(stringPool.allocate_idx(), -1);
+
+    Test::min_verbosity = prevTestVerbosity;    
+}
+
+test(stringpool_intern)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test stringpool_intern starting.");
+    const int numStrings = 5;
+    StringPool<numStrings, 8> stringPool;
+
+    assertTrue(stringPool.interning());
+    int idx = stringPool.intern_idx("num");
+    assertTrue(stringPool.is_interned(idx));
+    assertEqual(stringPool.c_str(idx), "num");
+    assertEqual(stringPool.intern_idx("num"), idx);
+    assertEqual(stringPool.ref_count(idx), 2);
+    assertEqual(stringPool.available(), numStrings - 1);
+    assertNotEqual(stringPool.intern_idx("nums"), idx);
+    assertFalse(stringPool.is_interned(stringPool.allocate_idx()));
+
+    // A released index is no longer found by interning
+    assertTrue(stringPool.deallocate_idx(idx));
+    assertTrue(stringPool.deallocate_idx(idx));
+    assertFalse(stringPool.is_interned(idx));
+    int otherIdx = stringPool.intern_idx("num");
+    assertEqual(stringPool.ref_count(otherIdx), 1);
+    stringPool.deallocate_idx(otherIdx);
+
+    stringPool.set_interning(false);
+    idx = stringPool.intern_idx("num");
+    assertFalse(stringPool.is_interned(idx));
+    assertNotEqual(stringPool.intern_idx("num"), idx);
+
+    // A string that does not fit in the bytes left is not interned
+    StringPool<numStrings, 16, 20> smallPool;
+    assertEqual(smallPool.intern_idx("abcdefghijklmnop"), -1);
+    assertEqual(smallPool.available(), numStrings);
+    idx = smallPool.intern_idx("abcdefgh");
+    assertEqual(smallPool.c_str(idx), "abcdefgh");
+    assertEqual(smallPool.intern_idx("abcdefgh"), idx);
+    assertTrue(smallPool.deallocate_idx(idx));
+    assertTrue(smallPool.deallocate_idx(idx));
+    assertEqual(smallPool.available(), numStrings);
+
+    Test::min_verbosity = prevTestVerbosity;    
+}
+
+test(stringpool_packed)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test stringpool_packed starting.");
+    // Only enough bytes for 4 fixed slots of 17 bytes
+    StringPool<16, 16, 80> stringPool;
+    int indices[8];
+
+    // Short strings only take the bytes they need
+    for (int i = 0; i < 8; ++i) {
+        indices[i] = stringPool.allocate_idx();
+        assertEqual(stringPool.bytes_taken(), 10 * i, "i = " << i);
+        stringPool.strcpy(indices[i], "ab");
+    }
+    for (int i = 0; i < 8; ++i) {
+        assertEqual(stringPool.c_str(indices[i]), "ab", "i = " << i);
+    }
+    assertEqual(stringPool.bytes_taken(), 80);
+
+    // Released bytes are compacted to make room for a longer string
+    for (int i = 0; i < 8; i += 2) {
+        assertTrue(stringPool.deallocate_idx(indices[i]));
+    }
+    int longIdx = stringPool.allocate_idx();
+    stringPool.strcpy(longIdx, "abcdefghijklmnop");
+    assertEqual(stringPool.c_str(longIdx), "abcdefghijklmnop");
+    for (int i = 1; i < 8; i += 2) {
+        assertEqual(stringPool.c_str(indices[i]), "ab", "i = " << i);
+    }
+
+    // A string copied from a string that moves during compaction
+    assertTrue(stringPool.deallocate_idx(indices[1]));
+    stringPool.strcat(indices[7], "cd");
+    int copyIdx = stringPool.allocate_idx();
+    stringPool.strcpy(copyIdx, stringPool.c_str(indices[7]));
+    assertEqual(stringPool.c_str(copyIdx), "abcd");
+    assertEqual(stringPool.c_str(indices[7]), "abcd");
+
+    // Strings are truncated when there are no bytes left
+    int fullIdx = stringPool.allocate_idx();
+    stringPool.strcpy(fullIdx, "abcdefghijklmnop");
+    assertEqual(stringPool.c_str(fullIdx), "abcde");
+    assertEqual(stringPool.strlen(fullIdx), 5);
+    assertEqual(stringPool.bytes_taken(), 80);
+    assertEqual(stringPool.c_str(longIdx), "abcdefghijklmnop");
+
+    Test::min_verbosity = prevTestVerbosity;    
+}
+
+test(stringpool_strlen)
+{
+    int prevTestVerbosity = Test::min_verbosity;
+    
+    Serial.println("Test stringpool_strlen starting.");
+    StringPool<5, 8> stringPool;
+    int idx = stringPool.allocate_idx();
+    assertEqual(stringPool.strlen(idx), 0);
+    assertEqual(stringPool.strlen(-1), -1);
+
+    // Length is kept up to date by every write
+    stringPool.strcpy(idx, "abc");
+    assertEqual(stringPool.strlen(idx), 3);
+    stringPool.strcat(idx, "de");
+    assertEqual(stringPool.strlen(idx), 5);
+    stringPool.strcat(idx, "fghij");
+    assertEqual(stringPool.strlen(idx), 8);
+    assertEqual(stringPool.c_str(idx), "abcdefgh");
+    stringPool.strcpy(idx, "");
+    assertEqual(stringPool.strlen(idx), 0);
+
+    // Direct writes are picked up once the length is invalidated
+    stringPool.strcpy(idx, "abcdef");
+    stringPool.c_str(idx)[2] = '\0';
+    stringPool.invalidate_len(idx);
+    assertEqual(stringPool.strlen(idx), 2);
+    stringPool.strcat(idx, "z");
+    assertEqual(stringPool.c_str(idx), "abz");
+    assertEqual(stringPool.strlen(idx), 3);
+
+    // Only the given number of characters are copied
+    stringPool.strncpy(idx, "ghijklmnop", 4);
+    assertEqual(stringPool.c_str(idx), "ghij");
+    assertEqual(stringPool.strlen(idx), 4);
+    stringPool.strncpy(idx, "ghijklmnop", 10);
+    assertEqual(stringPool.c_str(idx), "ghijklmn");
+    assertEqual(stringPool.strlen(idx), 8);
+
+    Test::min_verbosity = prevTestVerbosity;    
+}
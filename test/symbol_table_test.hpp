@@ -0,0 +1,112 @@
+#pragma once
+
+#include <kty/containers/string.hpp>
+#include <kty/containers/stringpool.hpp>
+#include <kty/containers/symbol_table.hpp>
+#include <kty/sizes.hpp>
+
+using namespace kty;
+
+test(symbol_table_insert_and_find) {
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test symbol_table_insert_and_find starting.");
+    SymbolTable<int, 8> table;
+    assertTrue(table.is_empty());
+    assertEqual(table.capacity(), 8);
+    assertTrue(table.find(PoolString<>("a")) == nullptr);
+
+    assertEqual(*table.insert(PoolString<>("a"), 1), 1);
+    assertEqual(*table.insert(PoolString<>("b"), 2), 2);
+    assertEqual(table.size(), 2);
+    assertEqual(*table.find(PoolString<>("a")), 1);
+    assertEqual(*table.find(PoolString<>("b")), 2);
+    assertTrue(table.find(PoolString<>("c")) == nullptr);
+
+    // Setting an existing name changes its value in place
+    int * value = table.find(PoolString<>("a"));
+    assertTrue(table.insert(PoolString<>("a"), 3) == value);
+    assertEqual(*value, 3);
+    assertEqual(table.size(), 2);
+
+    table.clear();
+    assertTrue(table.is_empty());
+    assertTrue(table.find(PoolString<>("a")) == nullptr);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(symbol_table_full_and_probing) {
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test symbol_table_full_and_probing starting.");
+    int numStrings = stringPool.num_taken();
+    char const * names[] = {"first_name", "second_name", "third_name", "fourth_name"};
+    {
+        SymbolTable<int, 4> table;
+        for (int i = 0; i < 4; ++i) {
+            assertTrue(table.insert(PoolString<>(names[i]), i) != nullptr, "i = " << i);
+        }
+        assertTrue(table.is_full());
+        assertEqual(stringPool.num_taken(), numStrings + 4);
+
+        // Every name is found wherever probing placed it
+        for (int i = 0; i < 4; ++i) {
+            assertEqual(*table.find(PoolString<>(names[i])), i, "i = " << i);
+        }
+        assertTrue(table.find(PoolString<>("fifth_name")) == nullptr);
+        assertTrue(table.insert(PoolString<>("fifth_name"), 4) == nullptr);
+        assertTrue(table.insert(PoolString<>("third_name"), 5) != nullptr);
+        assertEqual(*table.find(PoolString<>("third_name")), 5);
+
+        // Names are interned, so equal names share their index
+        PoolString<> name("first_name");
+        name.intern();
+        assertEqual(stringPool.num_taken(), numStrings + 4);
+
+        table.clear();
+        assertEqual(stringPool.num_taken(), numStrings + 1);
+    }
+    assertEqual(stringPool.num_taken(), numStrings);
+    assertTrue((SymbolTable<int, 4>::hash("") != 0));
+
+    Test::min_verbosity = prevTestVerbosity;
+}
+
+test(symbol_table_bind) {
+    int prevTestVerbosity = Test::min_verbosity;
+
+    Serial.println("Test symbol_table_bind starting.");
+    SymbolTable<int, 8> table;
+    assertFalse(table.is_current(SymbolBinding()));
+
+    table.insert(PoolString<>("a"), 1);
+    SymbolBinding a = table.bind(PoolString<>("a"));
+    assertTrue(table.is_current(a));
+    assertEqual(*table.find(a), 1);
+
+    // Setting the value keeps the binding current
+    table.insert(PoolString<>("a"), 2);
+    assertTrue(table.is_current(a));
+    assertEqual(*table.find(a), 2);
+
+    // A name bound before it is added stops being current when it is added
+    SymbolBinding b = table.bind(PoolString<>("b"));
+    assertTrue(table.is_current(b));
+    assertTrue(table.find(b) == nullptr);
+    table.insert(PoolString<>("b"), 3);
+    assertFalse(table.is_current(b));
+    b = table.bind(PoolString<>("b"));
+    assertEqual(*table.find(b), 3);
+
+    // Clearing the table makes every binding to a name stale
+    table.clear();
+    assertFalse(table.is_current(a));
+    assertFalse(table.is_current(b));
+    assertTrue(table.find(a) == nullptr);
+    table.insert(PoolString<>("a"), 4);
+    assertFalse(table.is_current(a));
+    assertEqual(*table.find(table.bind(PoolString<>("a"))), 4);
+
+    Test::min_verbosity = prevTestVerbosity;
+}
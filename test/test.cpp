@@ -15,10 +15,14 @@ MockArduinoLog Log;
 #include <kty/containers/allocator.hpp>
 #include <kty/containers/deque.hpp>
 #include <kty/containers/deque_of_deque.hpp>
+#include <kty/containers/ring_deque.hpp>
 #include <kty/containers/string.hpp>
+#include <kty/containers/string_view.hpp>
 #include <kty/containers/stringpool.hpp>
+#include <kty/containers/symbol_table.hpp>
 
 #include <kty/analyzer.hpp>
+#include <kty/compiler.hpp>
 #include <kty/interpreter.hpp>
 #include <kty/machine_state.hpp>
 #include <kty/parser.hpp>
@@ -29,7 +33,7 @@ MockArduinoLog Log;
 
 using namespace kty;
 
-Allocator<>         alloc;
+SlabAllocator<>     alloc;
 StringPool<>        stringPool;
 GetAllocInit<>      getAllocInit(alloc);
 GetStringPoolInit<> getStringPoolInit(stringPool);
@@ -43,10 +47,14 @@ Tokenizer<>         tokenizer;
 #include <test/allocator_test.hpp>
 #include <test/deque_test.hpp>
 #include <test/deque_of_deque_test.hpp>
+#include <test/ring_deque_test.hpp>
 #include <test/string_test.hpp>
+#include <test/string_view_test.hpp>
 #include <test/stringpool_test.hpp>
+#include <test/symbol_table_test.hpp>
 
 #include <test/analyzer_test.hpp>
+#include <test/compiler_test.hpp>
 #include <test/interpreter_test.hpp>
 #include <test/machine_state_test.hpp>
 #include <test/parser_test.hpp>
@@ -68,9 +76,12 @@ int main(void) {
     Test::exclude("*");
     Test::include("allocator*");
     Test::include("deque*");
+    Test::include("ring_deque*");
     Test::include("string*");
+    Test::include("symbol_table*");
 
     Test::include("analyzer*");
+    Test::include("compiler*");
     Test::include("interpreter*");
     Test::include("machine_state*");
     Test::include("parser*");
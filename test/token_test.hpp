@@ -14,23 +14,27 @@ test(token_constructor)
     /** First constructor type */
     Token<> token1;
     assertEqual(token1.get_type(), TokenType::UNKNOWN_TOKEN);
-    assertEqual(token1.get_value().c_str(), "");
+    PoolString<> tokenValue = token1.get_value();
+    assertEqual(tokenValue.c_str(), "");
 
     /** Second constructor type */
     Token<> token2(TokenType::CREATE_NUM);
     assertEqual(token2.get_type(), TokenType::CREATE_NUM);
-    assertEqual(token2.get_value().c_str(), "");
+    tokenValue = token2.get_value();
+    assertEqual(tokenValue.c_str(), "");
 
     /** Third constructor type */
     PoolString<> value("answer");
     Token<> token3(TokenType::NAME, value);
     assertEqual(token3.get_type(), TokenType::NAME);
-    assertEqual(token3.get_value().c_str(), "answer");
+    tokenValue = token3.get_value();
+    assertEqual(tokenValue.c_str(), "answer");
 
     value = "42";
     Token<> token4(TokenType::NUM_VAL, value);
     assertEqual(token4.get_type(), TokenType::NUM_VAL);
-    assertEqual(token4.get_value().c_str(), "42");
+    tokenValue = token4.get_value();
+    assertEqual(tokenValue.c_str(), "42");
 
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -44,19 +48,22 @@ test(token_getters_setters)
     Token<> token;
 
     assertEqual(token.get_type(), TokenType::UNKNOWN_TOKEN);
-    assertEqual(token.get_value().c_str(), "");
+    PoolString<> tokenValue = token.get_value();
+    assertEqual(tokenValue.c_str(), "");
 
     token.set_type(TokenType::NAME);
     value = "answer";
     token.set_value(value);
     assertEqual(token.get_type(), TokenType::NAME);
-    assertEqual(token.get_value().c_str(), "answer");
+    tokenValue = token.get_value();
+    assertEqual(tokenValue.c_str(), "answer");
 
     token.set_type(TokenType::NUM_VAL);
     value = "42";
     token.set_value(value);
     assertEqual(token.get_type(), TokenType::NUM_VAL);
-    assertEqual(token.get_value().c_str(), "42");
+    tokenValue = token.get_value();
+    assertEqual(tokenValue.c_str(), "42");
 
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -70,17 +77,20 @@ test(token_str)
 
     /** Empty value string */
     Token<> token(TokenType::CREATE_NUM, value);
-    assertEqual(token.str().c_str(), "Token(CREATE_NUM, )");
+    PoolString<> tokenStr = token.str();
+    assertEqual(tokenStr.c_str(), "Token(CREATE_NUM, )");
 
     /** With value string */
     value = "answer";
     token.set_type(TokenType::NAME);
     token.set_value(value);
-    assertEqual(token.str().c_str(), "Token(NAME, answer)");
+    tokenStr = token.str();
+    assertEqual(tokenStr.c_str(), "Token(NAME, answer)");
     value = "42";
     token.set_type(TokenType::NUM_VAL);
     token.set_value(value);
-    assertEqual(token.str().c_str(), "Token(NUM_VAL, 42)");
+    tokenStr = token.str();
+    assertEqual(tokenStr.c_str(), "Token(NUM_VAL, 42)");
 
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -63,14 +63,20 @@ test(tokenizer_get_additional_arguments)
 
     Serial.println("Test tokenizer_get_additional_arguments starting.");
 
-    assertEqual(tokenizer.get_additional_arguments(TokenType::CREATE_NUM, 0).c_str(), "0");
-    assertEqual(tokenizer.get_additional_arguments(TokenType::CREATE_NUM, 1).c_str(), "");
-
-    assertEqual(tokenizer.get_additional_arguments(TokenType::CREATE_LED, 1).c_str(), ",50");
-    assertEqual(tokenizer.get_additional_arguments(TokenType::CREATE_LED, 2).c_str(), "");
+    PoolString<> arguments = tokenizer.get_additional_arguments(TokenType::CREATE_NUM, 0);
+    assertEqual(arguments.c_str(), "0");
+    arguments = tokenizer.get_additional_arguments(TokenType::CREATE_NUM, 1);
+    assertEqual(arguments.c_str(), "");
+
+    arguments = tokenizer.get_additional_arguments(TokenType::CREATE_LED, 1);
+    assertEqual(arguments.c_str(), ",50");
+    arguments = tokenizer.get_additional_arguments(TokenType::CREATE_LED, 2);
+    assertEqual(arguments.c_str(), "");
     
-    assertEqual(tokenizer.get_additional_arguments(TokenType::RUN_GROUP, 0).c_str(), "1");
-    assertEqual(tokenizer.get_additional_arguments(TokenType::RUN_GROUP, 1).c_str(), "");
+    arguments = tokenizer.get_additional_arguments(TokenType::RUN_GROUP, 0);
+    assertEqual(arguments.c_str(), "1");
+    arguments = tokenizer.get_additional_arguments(TokenType::RUN_GROUP, 1);
+    assertEqual(arguments.c_str(), "");
     
     Test::min_verbosity = prevTestVerbosity;
 }
@@ -546,7 +552,9 @@ void tokenizer_check_tokens_match(Deque<Token<>> & generatedTokens,
     int i = 0;
     while (genIter != generatedTokens.end() && expIter != expectedTokens.end()) {
         assertEqual(genIter->get_type(), expIter->get_type(), "i = " << i << ": " << comment);
-        assertEqual(genIter->get_value().c_str(), expIter->get_value().c_str(), "i = " << i << ": " << comment);
+        PoolString<> genValue = genIter->get_value();
+        PoolString<> expValue = expIter->get_value();
+        assertEqual(genValue.c_str(), expValue.c_str(), "i = " << i << ": " << comment);
         ++genIter;
         ++expIter;
         ++i;